@@ -0,0 +1,507 @@
+// Title: Lab 6 - battleshipBench.cpp
+//
+// Purpose: Microbenchmarks of the hot paths of the game: the Grid
+//          operations, ship placement, loading the sample ship files, and
+//          whole headless games with each CPU strategy.  Every benchmark
+//          reports nanoseconds, heap allocations and throughput per
+//          operation, and the results can be written as JSON to compare
+//          commits.
+//
+//          Usage: BattleshipBench [-time seconds] [-filter text] [-json file]
+//                                 [-label text] [-data directory]
+//
+//          Each benchmark runs its timed batches for about seconds
+//          (default 0.2) five times over and reports the median run.
+//          -filter runs only the benchmarks whose names contain text.
+//          -label names the build in the JSON report, e.g. a commit id, and
+//          the report records the build type it was compiled as.
+//          The sample ship files are read from directory, by default the
+//          source directory.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "simulator.h"
+
+using namespace std;
+
+#ifndef SAMPLE_DIR
+#define SAMPLE_DIR "."
+#endif
+
+const double DEFAULT_SECONDS = 0.2;
+const int RUNS = 5;
+const uint64_t SEED = 2020;
+
+// Grids, layouts or games per batch
+const int BATCH = 64;
+const int GAME_BATCH = 4;
+
+// Ship files shipped with the game, good and bad
+const char* const SAMPLE_FILES[] = {
+    "fiveShips.txt", "longShips.txt", "otherShips.txt", "oneShip.txt", "tinyShip.txt",
+    "offGrid.txt", "overlap.txt", "overlap2.txt", "tooMany.txt"
+};
+
+// Heap allocations made so far by operator new.  The replacements are kept
+// out of line, or GCC sees malloc and free through the inlined new and
+// delete and warns that they do not match
+static long allocations = 0;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    void* p;
+
+    allocations ++;
+    p = malloc(size ? size : 1);
+    if (!p) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// Results are added in here so the compiler cannot drop the work
+static volatile long sink = 0;
+
+//  A benchmark: Setup prepares a batch outside the timing, Run does the
+//      timed work and returns the number of operations it did
+class Benchmark {
+public:
+    Benchmark(const string& name) : _name(name) {}
+    virtual ~Benchmark() {}
+
+    const string& GetName() const { return _name; }
+    virtual void Setup() {}
+    virtual long Run() = 0;
+
+private:
+    string _name;
+};
+
+// Result of a benchmark
+//      name - name of the benchmark
+//      ops - operations timed in the median run
+//      nsPerOp - nanoseconds per operation in the median run
+//      nsPerOpMin - nanoseconds per operation in the fastest run
+//      allocsPerOp - heap allocations per operation over all runs
+struct BenchResult {
+    string name;
+    long ops;
+    double nsPerOp;
+    double nsPerOpMin;
+    double allocsPerOp;
+};
+
+//  Make grids with the classic ships placed at random
+//  Parameters:
+//      grids - receives BATCH grids
+//      rng - random number generator
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void PlacedGrids(vector<Grid>& grids, Rng& rng) {
+    grids.assign(BATCH, Grid());
+    for (int i = 0; i < BATCH; i ++) {
+        grids[i].RandomlyPlaceShips(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, rng);
+    }
+}
+
+//  Fire at every square of freshly placed grids in random order
+class FireShotBench : public Benchmark {
+public:
+    FireShotBench() : Benchmark("Grid::FireShot"), _rng(SEED) {
+        PlacedGrids(_placed, _rng);
+        _grids = _placed;
+        for (int i = 0; i < COUNT_SQUARES; i ++) {
+            int j = _rng.Below(i + 1);
+
+            _order[i] = _order[j];
+            _order[j] = i;
+        }
+    }
+
+    void Setup() override {
+        for (int i = 0; i < BATCH; i ++) {
+            _grids[i] = _placed[i];
+        }
+    }
+
+    long Run() override {
+        long hits = 0;
+
+        for (int i = 0; i < BATCH; i ++) {
+            for (int s = 0; s < COUNT_SQUARES; s ++) {
+                Outcome outcome;
+
+                _grids[i].FireShot(_order[s] / COUNT_COLUMNS, _order[s] % COUNT_COLUMNS, outcome);
+                hits += outcome != SHOT_MISSED;
+            }
+        }
+        sink += hits;
+        return BATCH*COUNT_SQUARES;
+    }
+
+private:
+    Rng _rng;
+    vector<Grid> _placed;
+    vector<Grid> _grids;
+    int _order[COUNT_SQUARES];
+};
+
+//  Look up the ship on every square of placed grids
+class FindShipBench : public Benchmark {
+public:
+    FindShipBench() : Benchmark("Grid::FindShip"), _rng(SEED) {
+        PlacedGrids(_grids, _rng);
+    }
+
+    long Run() override {
+        long found = 0;
+
+        for (int i = 0; i < BATCH; i ++) {
+            for (int r = 0; r < COUNT_ROWS; r ++) {
+                for (int c = 0; c < COUNT_COLUMNS; c ++) {
+                    found += _grids[i].FindShip(r, c);
+                }
+            }
+        }
+        sink += found;
+        return BATCH*COUNT_SQUARES;
+    }
+
+private:
+    Rng _rng;
+    vector<Grid> _grids;
+};
+
+//  Read the status of every square of grids half shot at
+class GetSquareStatusBench : public Benchmark {
+public:
+    GetSquareStatusBench() : Benchmark("Grid::GetSquareStatus"), _rng(SEED) {
+        PlacedGrids(_grids, _rng);
+        for (int i = 0; i < BATCH; i ++) {
+            for (int s = 0; s < COUNT_SQUARES/2; s ++) {
+                int square = _rng.Below(COUNT_SQUARES);
+                Outcome outcome;
+
+                _grids[i].FireShot(square / COUNT_COLUMNS, square % COUNT_COLUMNS, outcome);
+            }
+        }
+    }
+
+    long Run() override {
+        long total = 0;
+
+        for (int i = 0; i < BATCH; i ++) {
+            for (int r = 0; r < COUNT_ROWS; r ++) {
+                for (int c = 0; c < COUNT_COLUMNS; c ++) {
+                    total += _grids[i].GetSquareStatus(r, c);
+                }
+            }
+        }
+        sink += total;
+        return BATCH*COUNT_SQUARES;
+    }
+
+private:
+    Rng _rng;
+    vector<Grid> _grids;
+};
+
+//  Add the classic ships of random layouts to empty grids
+class AddShipBench : public Benchmark {
+public:
+    AddShipBench() : Benchmark("Grid::AddShip"), _rng(SEED) {
+        vector<Grid> placed;
+
+        PlacedGrids(placed, _rng);
+        _grids.assign(BATCH, Grid());
+        _empty = Grid();
+        _ships.resize(BATCH*CLASSIC_SHIP_COUNT);
+        for (int i = 0; i < BATCH; i ++) {
+            for (int j = 0; j < CLASSIC_SHIP_COUNT; j ++) {
+                placed[i].GetShip(j, _ships[i*CLASSIC_SHIP_COUNT + j]);
+            }
+        }
+    }
+
+    void Setup() override {
+        for (int i = 0; i < BATCH; i ++) {
+            _grids[i] = _empty;
+        }
+    }
+
+    long Run() override {
+        long added = 0;
+
+        for (int i = 0; i < BATCH; i ++) {
+            for (int j = 0; j < CLASSIC_SHIP_COUNT; j ++) {
+                const Ship& ship = _ships[i*CLASSIC_SHIP_COUNT + j];
+
+                added += _grids[i].AddShip(ship.name, ship.size, ship.isVertical, ship.startRow, ship.startColumn);
+            }
+        }
+        sink += added;
+        return BATCH*CLASSIC_SHIP_COUNT;
+    }
+
+private:
+    Rng _rng;
+    Grid _empty;
+    vector<Grid> _grids;
+    vector<Ship> _ships;
+};
+
+//  Place the classic ships at random on a grid of some size
+class RandomlyPlaceShipsBench : public Benchmark {
+public:
+    RandomlyPlaceShipsBench(int rows, int columns)
+            : Benchmark("Grid::RandomlyPlaceShips/" + to_string(rows) + "x" + to_string(columns)),
+              _rng(SEED), _grid(rows, columns) {}
+
+    long Run() override {
+        for (int i = 0; i < BATCH; i ++) {
+            _grid.RandomlyPlaceShips(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, _rng);
+            sink += _grid.GetShipsDeployed();
+        }
+        return BATCH;
+    }
+
+private:
+    Rng _rng;
+    Grid _grid;
+};
+
+//  Read a sample ship file, rewinding it before each read
+class LoadShipsBench : public Benchmark {
+public:
+    LoadShipsBench(const string& directory, const string& fileName)
+            : Benchmark("Grid::LoadShips/" + fileName), _file(directory + "/" + fileName) {}
+
+    bool IsOpen() const { return _file.is_open(); }
+
+    long Run() override {
+        long loaded = 0;
+
+        for (int i = 0; i < BATCH; i ++) {
+            _file.clear();
+            _file.seekg(0);
+            loaded += _grid.LoadShips(_file);
+        }
+        sink += loaded;
+        return BATCH;
+    }
+
+private:
+    ifstream _file;
+    Grid _grid;
+};
+
+//  Play whole headless games, one strategy against itself
+class GameBench : public Benchmark {
+public:
+    GameBench(const string& name, StrategyKind kind)
+            : Benchmark("Simulator::PlayGame/" + name),
+              _simulator(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, kind, kind) {
+        _game = 0;
+    }
+
+    long Run() override {
+        for (int i = 0; i < GAME_BATCH; i ++) {
+            Rng rng(SEED, _game++);
+
+            sink += _simulator.PlayGame(rng);
+        }
+        return GAME_BATCH;
+    }
+
+private:
+    Simulator _simulator;
+    long _game;
+};
+
+//  Run a benchmark RUNS times, each run timing batches for about seconds
+//  Parameters:
+//      bench - the benchmark
+//      seconds - time to spend per run
+//  Returns:
+//      the result of the median run
+//  Possible Errors:
+//      none
+BenchResult Measure(Benchmark& bench, double seconds) {
+    vector<pair<double, long>> runs;
+    long allocs;
+    long ops;
+    BenchResult result;
+
+    // One untimed batch to warm the caches
+    bench.Setup();
+    bench.Run();
+
+    allocs = 0;
+    ops = 0;
+    for (int run = 0; run < RUNS; run ++) {
+        chrono::duration<double> elapsed(0);
+        long runOps = 0;
+
+        while (elapsed.count() < seconds) {
+            chrono::steady_clock::time_point start;
+            long before;
+
+            bench.Setup();
+            before = allocations;
+            start = chrono::steady_clock::now();
+            runOps += bench.Run();
+            elapsed += chrono::steady_clock::now() - start;
+            allocs += allocations - before;
+        }
+        runs.push_back(make_pair(elapsed.count()*1e9/runOps, runOps));
+        ops += runOps;
+    }
+    sort(runs.begin(), runs.end());
+
+    result.name = bench.GetName();
+    result.ops = runs[RUNS/2].second;
+    result.nsPerOp = runs[RUNS/2].first;
+    result.nsPerOpMin = runs[0].first;
+    result.allocsPerOp = (double)allocs / ops;
+    return result;
+}
+
+//  Write the results as JSON
+//  Parameters:
+//      fileName - name of the file
+//      label - name of the build
+//      results - the results
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be created or written
+bool WriteJson(const string& fileName, const string& label, const vector<BenchResult>& results) {
+    ofstream file(fileName);
+
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "{\n  \"label\": \"";
+    for (char c : label) {
+        if ('"' == c || '\\' == c) {
+            file << '\\';
+        }
+        file << c;
+    }
+    file << "\",\n  \"build_type\": \"" << BUILD_TYPE << "\",\n  \"benchmarks\": [\n" << setprecision(6);
+    for (size_t i = 0; i < results.size(); i ++) {
+        const BenchResult& result = results[i];
+
+        file << "    { \"name\": \"" << result.name << "\", \"ops\": " << result.ops
+             << ", \"ns_per_op\": " << result.nsPerOp
+             << ", \"ns_per_op_min\": " << result.nsPerOpMin
+             << ", \"allocs_per_op\": " << result.allocsPerOp
+             << ", \"ops_per_second\": " << 1e9/result.nsPerOp << " }"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    file.close();
+    return !file.fail();
+}
+
+int main(int argc, char* argv[]) {
+    double seconds;
+    string filter;
+    string jsonFile;
+    string label;
+    string directory;
+    vector<unique_ptr<Benchmark>> benches;
+    vector<BenchResult> results;
+
+    seconds = DEFAULT_SECONDS;
+    directory = SAMPLE_DIR;
+    for (int i = 1; i < argc; i ++) {
+        string option = argv[i];
+
+        if (i + 1 < argc && "-time" == option) {
+            seconds = atof(argv[++i]);
+        }
+        else if (i + 1 < argc && "-filter" == option) {
+            filter = argv[++i];
+        }
+        else if (i + 1 < argc && "-json" == option) {
+            jsonFile = argv[++i];
+        }
+        else if (i + 1 < argc && "-label" == option) {
+            label = argv[++i];
+        }
+        else if (i + 1 < argc && "-data" == option) {
+            directory = argv[++i];
+        }
+        else {
+            seconds = 0;
+            break;
+        }
+    }
+    if (seconds <= 0) {
+        cerr << "Usage: " << argv[0] << " [-time seconds] [-filter text] [-json file]" << endl;
+        cerr << "       " << string(strlen(argv[0]), ' ') << " [-label text] [-data directory]" << endl;
+        return 1;
+    }
+
+    benches.emplace_back(new FireShotBench());
+    benches.emplace_back(new FindShipBench());
+    benches.emplace_back(new GetSquareStatusBench());
+    benches.emplace_back(new AddShipBench());
+    benches.emplace_back(new RandomlyPlaceShipsBench(COUNT_ROWS, COUNT_COLUMNS));
+    benches.emplace_back(new RandomlyPlaceShipsBench(2*COUNT_ROWS, 2*COUNT_COLUMNS));
+    for (const char* fileName : SAMPLE_FILES) {
+        LoadShipsBench* bench = new LoadShipsBench(directory, fileName);
+
+        benches.emplace_back(bench);
+        if (!bench->IsOpen()) {
+            cerr << "Cannot open " << directory << "/" << fileName << endl;
+            return 1;
+        }
+    }
+    benches.emplace_back(new GameBench("hunt", HUNT_TARGET));
+    benches.emplace_back(new GameBench("endgame", HUNT_TARGET_ENDGAME));
+    benches.emplace_back(new GameBench("density", PROBABILITY_DENSITY));
+
+    cout << left << setw(40) << "benchmark" << right << setw(14) << "ns/op"
+         << setw(14) << "allocs/op" << setw(16) << "ops/s" << endl;
+    for (unique_ptr<Benchmark>& bench : benches) {
+        BenchResult result;
+
+        if (bench->GetName().find(filter) == string::npos) {
+            continue;
+        }
+        result = Measure(*bench, seconds);
+        results.push_back(result);
+        cout << left << setw(40) << result.name << right << fixed
+             << setw(14) << setprecision(1) << result.nsPerOp
+             << setw(14) << setprecision(3) << result.allocsPerOp
+             << setw(16) << setprecision(0) << 1e9/result.nsPerOp << endl;
+    }
+
+    if (!jsonFile.empty() && !WriteJson(jsonFile, label, results)) {
+        cerr << "Cannot write " << jsonFile << endl;
+        return 1;
+    }
+    return 0;
+}
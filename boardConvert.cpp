@@ -0,0 +1,134 @@
+// Title: Lab 6 - boardConvert.cpp
+//
+// Purpose: Convert ship layouts between the text format read by
+//          Grid::LoadShips (one or more layouts back to back) and the
+//          binary board format declared in boardFile.h
+//
+//          Usage: BoardConvert text2bin [-size rows columns ships] input.txt... output.bin
+//                 BoardConvert bin2text input.bin output.txt
+//
+//          Text layouts are read onto a 10x10 grid of up to SHIPS_MAX
+//          ships unless -size is given.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "boardFile.h"
+
+//  Convert text layout files to one binary file
+//  Parameters:
+//      inputs - names of the text files
+//      count - number of text files
+//      output - name of the binary file
+//      rows, columns, shipsMax - size of the grid the layouts are for
+//  Returns:
+//      process exit code
+//  Possible Errors:
+//      unreadable file, badly formed layout, write failure
+int TextToBinary(char* inputs[], int count, const string& output, int rows, int columns, int shipsMax) {
+    BoardFileWriter writer;
+    long boards;
+
+    if (!writer.Open(output, rows, columns, shipsMax)) {
+        cerr << "Cannot create " << output << endl;
+        return 1;
+    }
+    boards = 0;
+    for (int i = 0; i < count; i ++) {
+        ifstream file(inputs[i]);
+
+        if (!file.is_open()) {
+            cerr << "Cannot open " << inputs[i] << endl;
+            return 1;
+        }
+        // Layouts follow each other until only whitespace is left
+        while (!(file >> ws).eof()) {
+            Grid grid(rows, columns, shipsMax);
+
+            if (!grid.LoadShips(file)) {
+                cerr << inputs[i] << ": bad layout after " << boards << " boards" << endl;
+                return 1;
+            }
+            if (!writer.Add(grid)) {
+                cerr << "Cannot write " << output << endl;
+                return 1;
+            }
+            boards ++;
+        }
+    }
+    if (!writer.Close()) {
+        cerr << "Cannot write " << output << endl;
+        return 1;
+    }
+    cout << boards << " boards written to " << output << endl;
+    return 0;
+}
+
+//  Convert a binary file to text layouts back to back
+//  Parameters:
+//      input - name of the binary file
+//      output - name of the text file
+//  Returns:
+//      process exit code
+//  Possible Errors:
+//      unreadable file, bad record, write failure
+int BinaryToText(const string& input, const string& output) {
+    BoardCorpus corpus;
+    ofstream file;
+
+    if (!corpus.Open(input)) {
+        cerr << "Cannot open board file " << input << endl;
+        return 1;
+    }
+    file.open(output);
+    if (!file.is_open()) {
+        cerr << "Cannot create " << output << endl;
+        return 1;
+    }
+    for (long i = 0; i < corpus.GetCount(); i ++) {
+        Grid grid(corpus.GetRows(), corpus.GetColumns(), corpus.GetShipsMax());
+
+        if (!corpus.GetBoard(i).LoadInto(grid)) {
+            cerr << input << ": bad record " << i << endl;
+            return 1;
+        }
+        if (!grid.SaveShips(file)) {
+            cerr << "Cannot write " << output << endl;
+            return 1;
+        }
+    }
+    cout << corpus.GetCount() << " boards written to " << output << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    string mode;
+    int first;
+    int rows;
+    int columns;
+    int shipsMax;
+
+    mode = argc > 1 ? argv[1] : "";
+    first = 2;
+    rows = COUNT_ROWS;
+    columns = COUNT_COLUMNS;
+    shipsMax = SHIPS_MAX;
+    if (mode == "text2bin" && argc > 5 && string(argv[2]) == "-size") {
+        rows = atoi(argv[3]);
+        columns = atoi(argv[4]);
+        shipsMax = atoi(argv[5]);
+        first = 6;
+    }
+    if (mode == "text2bin" && argc >= first + 2) {
+        return TextToBinary(argv + first, argc - first - 1, argv[argc-1], rows, columns, shipsMax);
+    }
+    if (mode == "bin2text" && argc == 4) {
+        return BinaryToText(argv[2], argv[3]);
+    }
+    cerr << "Usage: " << argv[0] << " text2bin [-size rows columns ships] input.txt... output.bin" << endl;
+    cerr << "       " << argv[0] << " bin2text input.bin output.txt" << endl;
+    return 1;
+}
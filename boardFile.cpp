@@ -0,0 +1,346 @@
+// Title: Lab 6 - boardFile.cpp
+//
+// Purpose: Implements the classes that read and write the compact binary
+//          board format declared in boardFile.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "boardFile.h"
+
+//  Return the number of bytes a ship takes in a file
+//  Parameters:
+//      header - header of the file
+//  Returns:
+//      BOARD_SHIP_BYTES or BOARD_SHIP_BYTES_WIDE
+//  Possible Errors:
+//      none
+static inline int ShipBytes(const BoardFileHeader& header) {
+    return BOARD_FILE_VERSION_WIDE == header.version ? BOARD_SHIP_BYTES_WIDE : BOARD_SHIP_BYTES;
+}
+
+//
+//  Constructor
+BoardView::BoardView(const BoardFileHeader* header, const unsigned char* record) {
+    _header = header;
+    _record = record;
+}
+
+//  Return the number of ships on the board
+//  Parameters:
+//      none
+//  Returns:
+//      ship count
+//  Possible Errors:
+//      none
+int BoardView::GetShipCount() const {
+    return _record[0];
+}
+
+//  Retrieve a ship of the board
+//  Parameters:
+//      i - index of the ship (0 <= i < GetShipCount())
+//      ship - receives the ship
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void BoardView::GetShip(int i, Ship& ship) const {
+    int shipBytes = ShipBytes(*_header);
+    const unsigned char* s = _record + 1 + i*shipBytes;
+    const char* name = _header->names[s[0] < BOARD_NAMES_MAX ? s[0] : 0];
+    int square;
+
+    square = s[2];
+    if (BOARD_SHIP_BYTES_WIDE == shipBytes) {
+        square |= s[3] << 8;
+    }
+    ship.name.assign(name, strnlen(name, BOARD_NAME_LENGTH));
+    ship.size = s[1] & ~BOARD_VERTICAL;
+    ship.isVertical = (s[1] & BOARD_VERTICAL) != 0;
+    ship.startRow = square / _header->columns;
+    ship.startColumn = square % _header->columns;
+    ship.hits = 0;
+}
+
+//  Place the ships of the board on a grid
+//  Parameters:
+//      grid - grid to fill, it should be empty and the size of the file's
+//          grid (see BoardCorpus::GetRows and GetColumns)
+//  Returns:
+//      true if every ship was added
+//  Possible Errors:
+//      grid of a different size, too many ships, ships off the grid or
+//      overlapping
+bool BoardView::LoadInto(Grid& grid) const {
+    if (grid.GetRows() != _header->rows || grid.GetColumns() != _header->columns
+        || _record[0] > _header->shipsMax) {
+        return false;
+    }
+    for (int i = 0; i < _record[0]; i ++) {
+        Ship ship;
+
+        GetShip(i, ship);
+        if (!grid.AddShip(ship.name, ship.size, ship.isVertical, ship.startRow, ship.startColumn)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+//  Constructor
+BoardCorpus::BoardCorpus() {
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _records = nullptr;
+}
+
+//
+//  Destructor
+//      Unmaps the file
+BoardCorpus::~BoardCorpus() {
+    Close();
+}
+
+//  Map a board file into memory and check its header
+//  Parameters:
+//      fileName - name of the file
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be opened or mapped, wrong magic or version, a grid
+//      size out of range, or it is truncated
+bool BoardCorpus::Open(const string& fileName) {
+    int fd;
+    struct stat info;
+    void* data;
+
+    Close();
+    fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(BoardFileHeader)) {
+        close(fd);
+        return false;
+    }
+    data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data) {
+        return false;
+    }
+    _data = (const unsigned char*)data;
+    _size = info.st_size;
+    _header = (const BoardFileHeader*)_data;
+    _records = _data + sizeof(BoardFileHeader);
+
+    if (memcmp(_header->magic, BOARD_FILE_MAGIC, sizeof(BOARD_FILE_MAGIC)) != 0
+        || (_header->version != BOARD_FILE_VERSION && _header->version != BOARD_FILE_VERSION_WIDE)
+        || _header->rows < 1 || _header->rows > BOARD_SIDE_MAX
+        || _header->columns < 1 || _header->columns > BOARD_SIDE_MAX
+        || (BOARD_FILE_VERSION == _header->version
+            && _header->rows*_header->columns > BOARD_NARROW_SQUARES_MAX)
+        || _header->recordSize != 1 + _header->shipsMax*ShipBytes(*_header)
+        || _header->recordCount > (_size - sizeof(BoardFileHeader)) / _header->recordSize) {
+        Close();
+        return false;
+    }
+    madvise(data, _size, MADV_SEQUENTIAL);
+    return true;
+}
+
+//  Unmap the file, if one is open
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void BoardCorpus::Close() {
+    if (_data) {
+        munmap((void*)_data, _size);
+    }
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _records = nullptr;
+}
+
+//  Return the number of rows of the file's grid
+int BoardCorpus::GetRows() const {
+    return _header ? _header->rows : 0;
+}
+
+//  Return the number of columns of the file's grid
+int BoardCorpus::GetColumns() const {
+    return _header ? _header->columns : 0;
+}
+
+//  Return the most ships a board of the file holds
+int BoardCorpus::GetShipsMax() const {
+    return _header ? _header->shipsMax : 0;
+}
+
+//  Return the number of boards in the file
+//  Parameters:
+//      none
+//  Returns:
+//      board count, 0 if no file is open
+//  Possible Errors:
+//      none
+long BoardCorpus::GetCount() const {
+    return _header ? (long)_header->recordCount : 0;
+}
+
+//  Return a view of one board.  The view points into the mapping, so it
+//      must not be used after the corpus is closed
+//  Parameters:
+//      i - index of the board (0 <= i < GetCount())
+//  Returns:
+//      view of the board
+//  Possible Errors:
+//      none expected
+BoardView BoardCorpus::GetBoard(long i) const {
+    return BoardView(_header, _records + i*_header->recordSize);
+}
+
+//
+//  Constructor
+BoardFileWriter::BoardFileWriter() {
+    memset(&_header, 0, sizeof(_header));
+}
+
+//
+//  Destructor
+//      Finishes the file if Close was not called
+BoardFileWriter::~BoardFileWriter() {
+    if (_file.is_open()) {
+        Close();
+    }
+}
+
+//  Create a board file and write a placeholder header.  Grids of up to
+//      BOARD_NARROW_SQUARES_MAX squares are saved in version 1
+//  Parameters:
+//      fileName - name of the file
+//      rows, columns, shipsMax - size of the grids that will be added
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      grid size out of range, file cannot be created
+bool BoardFileWriter::Open(const string& fileName, int rows, int columns, int shipsMax) {
+    if (rows < 1 || rows > BOARD_SIDE_MAX || columns < 1 || columns > BOARD_SIDE_MAX
+        || shipsMax < 0 || shipsMax > SHIPS_LIMIT) {
+        return false;
+    }
+    memset(&_header, 0, sizeof(_header));
+    memcpy(_header.magic, BOARD_FILE_MAGIC, sizeof(BOARD_FILE_MAGIC));
+    _header.version = rows*columns <= BOARD_NARROW_SQUARES_MAX ? BOARD_FILE_VERSION : BOARD_FILE_VERSION_WIDE;
+    _header.rows = (uint8_t)rows;
+    _header.columns = (uint8_t)columns;
+    _header.shipsMax = (uint8_t)shipsMax;
+    _header.recordSize = (uint16_t)(1 + shipsMax*ShipBytes(_header));
+    _record.assign(_header.recordSize, 0);
+
+    _file.open(fileName, ios::binary | ios::trunc);
+    if (!_file.is_open()) {
+        return false;
+    }
+    _file.write((const char*)&_header, sizeof(_header));
+    return !_file.fail();
+}
+
+//  Append the ships of a grid as one record
+//  Parameters:
+//      grid - grid to save
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      grid of a different size than given to Open, more than
+//      BOARD_NAMES_MAX different ship names in the file, write failure
+bool BoardFileWriter::Add(const Grid& grid) {
+    int shipBytes = ShipBytes(_header);
+    int shipCount = grid.GetShipsDeployed();
+
+    if (grid.GetRows() != _header.rows || grid.GetColumns() != _header.columns
+        || shipCount > _header.shipsMax) {
+        return false;
+    }
+    fill(_record.begin(), _record.end(), 0);
+    _record[0] = (unsigned char)shipCount;
+    for (int i = 0; i < shipCount; i ++) {
+        unsigned char* s = &_record[1 + i*shipBytes];
+        Ship ship;
+        int nameIndex;
+        int square;
+
+        grid.GetShip(i, ship);
+        nameIndex = FindName(ship.name);
+        if (nameIndex < 0) {
+            return false;
+        }
+        square = ship.startRow*_header.columns + ship.startColumn;
+        s[0] = (unsigned char)nameIndex;
+        s[1] = (unsigned char)(ship.size | (ship.isVertical ? BOARD_VERTICAL : 0));
+        s[2] = (unsigned char)square;
+        if (BOARD_SHIP_BYTES_WIDE == shipBytes) {
+            s[3] = (unsigned char)(square >> 8);
+        }
+    }
+    _file.write((const char*)_record.data(), _record.size());
+    if (_file.fail()) {
+        return false;
+    }
+    _header.recordCount ++;
+    return true;
+}
+
+//  Write the final header and close the file
+//  Parameters:
+//      none
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      write failure
+bool BoardFileWriter::Close() {
+    bool ok;
+
+    _file.seekp(0);
+    _file.write((const char*)&_header, sizeof(_header));
+    ok = !_file.fail();
+    _file.close();
+    return ok;
+}
+
+//  Find a ship name in the header's name table, adding it if it is new.
+//      Names longer than BOARD_NAME_LENGTH are truncated
+//  Parameters:
+//      name - ship name
+//  Returns:
+//      index of the name, or -1 if the table is full
+//  Possible Errors:
+//      table full
+int BoardFileWriter::FindName(const string& name) {
+    char padded[BOARD_NAME_LENGTH];
+
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, name.c_str(), name.length() < BOARD_NAME_LENGTH ? name.length() : BOARD_NAME_LENGTH);
+    for (int i = 0; i < _header.nameCount; i ++) {
+        if (memcmp(_header.names[i], padded, BOARD_NAME_LENGTH) == 0) {
+            return i;
+        }
+    }
+    if (_header.nameCount >= BOARD_NAMES_MAX) {
+        return -1;
+    }
+    memcpy(_header.names[_header.nameCount], padded, BOARD_NAME_LENGTH);
+    return _header.nameCount++;
+}
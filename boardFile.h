@@ -0,0 +1,143 @@
+// Title: Lab 6 - boardFile.h
+//
+// Purpose: Declares the compact binary board format and the classes that
+//          read and write it.
+//
+//          A board file is a fixed size header followed by fixed size
+//          records, one per board.  The header holds the grid size and
+//          the table of ship names, so a ship takes three bytes: its
+//          name index, its size and orientation, and its start square.
+//          Grids of more than 256 squares use version 2 of the format,
+//          where the start square takes two bytes.  A corpus file is
+//          memory-mapped and boards are handed out as views straight
+//          into the mapping, without copying or parsing.
+//
+//          The two-byte square of a version 2 record is stored low byte
+//          first.  The header is written as a BoardFileHeader and read in
+//          place from the mapping, so its multi-byte fields are in the
+//          byte order of the host, and a file is only read back on hosts
+//          of the same byte order.  The header has no padding, so its
+//          layout does not depend on the compiler.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_BOARDFILE_H
+#define BATTLESHIP_BOARDFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "grid.h"
+
+// Format identification
+const char BOARD_FILE_MAGIC[4] = { 'B', 'S', 'H', 'P' };
+const uint16_t BOARD_FILE_VERSION = 1;
+const uint16_t BOARD_FILE_VERSION_WIDE = 2;
+
+// Size of the ship name table
+const int BOARD_NAMES_MAX = 32;
+const int BOARD_NAME_LENGTH = 16;
+
+// Bit of BoardRecordShip::sizeAndOrientation set for vertical ships
+const uint8_t BOARD_VERTICAL = 0x80;
+
+// Header at the start of a board file
+//      magic - BOARD_FILE_MAGIC
+//      version - BOARD_FILE_VERSION
+//      rows, columns, shipsMax - grid the boards were saved from
+//      nameCount - number of entries used in names
+//      recordSize - 1 + shipsMax * bytes per ship
+//      reserved - zero
+//      recordCount - number of records following the header
+//      names - ship names, NUL padded
+struct BoardFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint8_t rows;
+    uint8_t columns;
+    uint8_t shipsMax;
+    uint8_t nameCount;
+    uint16_t recordSize;
+    uint32_t reserved;
+    uint64_t recordCount;
+    char names[BOARD_NAMES_MAX][BOARD_NAME_LENGTH];
+};
+
+static_assert(offsetof(BoardFileHeader, recordCount) == 16 && offsetof(BoardFileHeader, names) == 24,
+              "the header fields must be packed without padding");
+static_assert(sizeof(BoardFileHeader) == 24 + BOARD_NAMES_MAX*BOARD_NAME_LENGTH,
+              "the header must be packed without padding");
+
+// A record is the ship count in one byte followed by shipsMax ships.
+// Each ship is
+//      nameIndex - index into BoardFileHeader::names
+//      sizeAndOrientation - size in the low bits, BOARD_VERTICAL if vertical
+//      square - startRow*columns + startColumn, one byte in version 1
+//               and two bytes in version 2
+const int BOARD_SHIP_BYTES = 3;
+const int BOARD_SHIP_BYTES_WIDE = 4;
+
+// Squares a grid may have to be saved in version 1
+const int BOARD_NARROW_SQUARES_MAX = 256;
+
+static_assert(BOARD_SIDE_MAX < BOARD_VERTICAL, "a size must fit beside the orientation bit");
+static_assert(BOARD_SIDE_MAX*BOARD_SIDE_MAX <= 65536, "a square must fit in two bytes");
+static_assert(SHIPS_LIMIT <= 255, "the ship count must fit in a byte");
+
+//  Zero-copy view of one board in a mapped corpus
+class BoardView {
+public:
+    BoardView(const BoardFileHeader* header, const unsigned char* record);
+
+    int GetShipCount() const;
+    void GetShip(int i, Ship& ship) const;
+    bool LoadInto(Grid& grid) const;
+
+private:
+    const BoardFileHeader* _header;
+    const unsigned char* _record;
+};
+
+//  Read-only, memory-mapped board file
+class BoardCorpus {
+public:
+    BoardCorpus();
+    ~BoardCorpus();
+
+    bool Open(const string& fileName);
+    void Close();
+
+    int GetRows() const;
+    int GetColumns() const;
+    int GetShipsMax() const;
+    long GetCount() const;
+    BoardView GetBoard(long i) const;
+
+private:
+    const unsigned char* _data;
+    size_t _size;
+    const BoardFileHeader* _header;
+    const unsigned char* _records;
+};
+
+//  Writes boards to a board file
+class BoardFileWriter {
+public:
+    BoardFileWriter();
+    ~BoardFileWriter();
+
+    bool Open(const string& fileName,
+              int rows = COUNT_ROWS, int columns = COUNT_COLUMNS, int shipsMax = SHIPS_MAX);
+    bool Add(const Grid& grid);
+    bool Close();
+
+private:
+    int FindName(const string& name);
+
+    ofstream _file;
+    BoardFileHeader _header;
+    vector<unsigned char> _record;
+};
+
+#endif //BATTLESHIP_BOARDFILE_H
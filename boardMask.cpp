@@ -0,0 +1,17 @@
+// Title: Lab 6 - boardMask.cpp
+//
+// Purpose: Holds the classic board's table of placement masks declared
+//          in boardMask.h
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include "boardMask.h"
+
+// The placement masks of the classic board, computed at compile time
+static constexpr PlacementMasks MASKS;
+
+//  Return the placement masks of the classic board
+const PlacementMasks& Masks() {
+    return MASKS;
+}
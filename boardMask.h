@@ -0,0 +1,238 @@
+// Title: Lab 6 - boardMask.h
+//
+// Purpose: Declares BoardMask, the whole grid as one 128-bit integer with
+//          square (row, column) at bit row*columns+column, and the
+//          helpers used to place and check ships with whole-board bit
+//          operations.  Grid and FixedGrid both lay out random ships here.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_BOARDMASK_H
+#define BATTLESHIP_BOARDMASK_H
+
+#include <cstdint>
+#include "grid.h"
+
+// The whole board as one integer, for shifting all rows at once
+typedef unsigned __int128 BoardMask;
+static_assert(COUNT_SQUARES <= 128, "board must fit in a BoardMask");
+
+//  Combine the words of a bitboard into a BoardMask
+inline BoardMask LoadMask(const uint64_t board[]) {
+    BoardMask mask = 0;
+
+    for (int i = BOARD_WORDS - 1; i >= 0; i --) {
+        mask = (mask << 32 << 32) | board[i];
+    }
+    return mask;
+}
+
+//  Return the mask of all squares on the board
+inline BoardMask SquaresMask() {
+    return COUNT_SQUARES == 128 ? ~(BoardMask)0 : ((BoardMask)1 << COUNT_SQUARES) - 1;
+}
+
+//  Masks used to place a ship of each size on a Rows x Columns board,
+//      computed at compile time
+//      squares - all squares of the board
+//      hStarts - squares where a horizontal ship can start without running
+//                off the end of its row
+//      hCount - number of squares in hStarts
+//      vCount - number of squares where a vertical ship can start
+//      hShip, vShip - squares of a horizontal/vertical ship starting at square 0
+template <int Rows, int Columns>
+struct FixedMasks {
+    static_assert(Rows > 0 && Columns > 0 && Rows*Columns <= 128, "board must fit in a BoardMask");
+    static constexpr int LENGTH_MAX = Rows > Columns ? Rows : Columns;
+
+    constexpr FixedMasks();
+
+    BoardMask squares;
+    BoardMask hStarts[LENGTH_MAX+1];
+    BoardMask hShip[LENGTH_MAX+1];
+    BoardMask vShip[LENGTH_MAX+1];
+    int hCount[LENGTH_MAX+1];
+    int vCount[LENGTH_MAX+1];
+};
+
+// The placement masks of the classic board
+typedef FixedMasks<COUNT_ROWS, COUNT_COLUMNS> PlacementMasks;
+
+//  Where one ship of a random layout goes
+//      ship - index of the ship in the roster
+//      isVertical - orientation
+//      bit - bit number of the start square
+struct Placement {
+    int ship;
+    bool isVertical;
+    int bit;
+};
+
+//  Count the bits of a word.  Done by hand because without a popcnt
+//      target __builtin_popcountll becomes a library call
+inline int Popcount64(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+
+//  Count the bits of a BoardMask
+inline int Popcount(BoardMask mask) {
+    return Popcount64((uint64_t)mask) + Popcount64((uint64_t)(mask >> 64));
+}
+
+//  Find the bit number of the n-th (from 0) set bit of a BoardMask
+inline int SelectBit(BoardMask mask, int n) {
+    uint64_t word;
+    int base;
+    int count;
+
+    word = (uint64_t)mask;
+    base = 0;
+    count = Popcount64(word);
+    if (n >= count) {
+        word = (uint64_t)(mask >> 64);
+        base = 64;
+        n -= count;
+    }
+    // Narrow down to the half that holds the bit
+    for (int width = 32; width >= 8; width /= 2) {
+        count = Popcount64(word & ((1ULL << width) - 1));
+        if (n >= count) {
+            word >>= width;
+            base += width;
+            n -= count;
+        }
+    }
+    while (n-- > 0) {
+        word &= word - 1;
+    }
+    return base + __builtin_ctzll(word);
+}
+
+// Placement masks of the classic board
+const PlacementMasks& Masks();
+
+//
+//  Constructor
+template <int Rows, int Columns>
+constexpr FixedMasks<Rows, Columns>::FixedMasks()
+        : squares(0), hStarts(), hShip(), vShip(), hCount(), vCount() {
+    squares = Rows*Columns == 128 ? ~(BoardMask)0 : ((BoardMask)1 << (Rows*Columns)) - 1;
+    for (int size = 0; size <= LENGTH_MAX; size ++) {
+        hCount[size] = size <= Columns ? Rows*(Columns - size + 1) : 0;
+        vCount[size] = size <= Rows ? Columns*(Rows - size + 1) : 0;
+        for (int r = 0; r < Rows; r ++) {
+            for (int c = 0; c + size <= Columns; c ++) {
+                hStarts[size] |= (BoardMask)1 << (r*Columns + c);
+            }
+        }
+        for (int k = 0; k < size && k < Columns; k ++) {
+            hShip[size] |= (BoardMask)1 << k;
+        }
+        for (int k = 0; k < size && k < Rows; k ++) {
+            vShip[size] |= (BoardMask)1 << (k*Columns);
+        }
+    }
+}
+
+//  Lay out ships at random on an empty board, for Grid and FixedGrid to
+//      place.  Each ship first makes a single guess among all its
+//      placements and keeps it if it is free, which is almost always the
+//      case on a sparse board.  Otherwise one of the legal placements is
+//      picked uniformly, found from the free squares with a few shifts of
+//      the whole board, so the result is uniform over the legal
+//      placements either way and there is no retry loop
+//  Parameters:
+//      masks - placement masks of the board
+//      ships - ships to place, only size is used
+//      shipCount - number of elements in ships
+//      shipsMax - the most ships the board holds
+//      rng - random number generator to use
+//      placements - receives where each placed ship goes, room for shipsMax
+//  Returns:
+//      number of ships placed
+//  Possible Errors:
+//      if a ship finds no room left the board is started over, after
+//      PLACEMENT_RESTARTS_MAX tries the ships placed so far are kept
+template <int Rows, int Columns>
+int RandomLayout(const FixedMasks<Rows, Columns>& masks, const Ship ships[], int shipCount, int shipsMax,
+                 Rng& rng, Placement placements[]) {
+    BoardMask occupied;
+    int placed;
+    int restarts;
+
+    occupied = 0;
+    placed = 0;
+    restarts = 0;
+    for (int i = 0; i < shipCount && placed < shipsMax; i ++) {
+        int size = ships[i].size;
+        BoardMask free;
+        BoardMask hStarts;
+        BoardMask vStarts;
+        BoardMask hShifted;
+        BoardMask vShifted;
+        BoardMask ship;
+        int hCount;
+        int vCount;
+        int pick;
+        int bit;
+        bool isVertical;
+
+        if (size <= 0 || size > masks.LENGTH_MAX || 0 == masks.hCount[size] + masks.vCount[size]) {
+            continue;
+        }
+
+        // Guess among all placements, free or not
+        pick = rng.Below(masks.hCount[size] + masks.vCount[size]);
+        isVertical = pick >= masks.hCount[size];
+        if (isVertical) {
+            bit = pick - masks.hCount[size];
+        }
+        else {
+            bit = pick / (Columns - size + 1) * Columns + pick % (Columns - size + 1);
+        }
+        ship = (isVertical ? masks.vShip[size] : masks.hShip[size]) << bit;
+
+        if ((ship & occupied) != 0) {
+            // A ship can start where it and the next size-1 squares are free
+            free = ~occupied & masks.squares;
+            hStarts = free & masks.hStarts[size];
+            vStarts = free;
+            hShifted = free;
+            vShifted = free;
+            for (int k = 1; k < size; k ++) {
+                hShifted >>= 1;
+                vShifted >>= Columns;
+                hStarts &= hShifted;
+                vStarts &= vShifted;
+            }
+            hCount = Popcount(hStarts);
+            vCount = Popcount(vStarts);
+            if (0 == hCount + vCount) {
+                if (++restarts < PLACEMENT_RESTARTS_MAX) {
+                    occupied = 0;
+                    placed = 0;
+                    i = -1;
+                }
+                continue;
+            }
+
+            pick = rng.Below(hCount + vCount);
+            isVertical = pick >= hCount;
+            bit = isVertical ? SelectBit(vStarts, pick - hCount) : SelectBit(hStarts, pick);
+            ship = (isVertical ? masks.vShip[size] : masks.hShip[size]) << bit;
+        }
+
+        occupied |= ship;
+        placements[placed].ship = i;
+        placements[placed].isVertical = isVertical;
+        placements[placed].bit = bit;
+        placed ++;
+    }
+    return placed;
+}
+
+#endif //BATTLESHIP_BOARDMASK_H
@@ -0,0 +1,75 @@
+// Title: Lab 6 - boardSnapshot.cpp
+//
+// Purpose: Implements the SnapshotSlot class declared in boardSnapshot.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <cstring>
+#include "boardSnapshot.h"
+
+//
+//  Constructor
+//      The reader starts with an empty snapshot in front
+SnapshotSlot::SnapshotSlot() {
+    memset(_buffers, 0, sizeof(_buffers));
+    for (int i = 0; i < 3; i ++) {
+        _buffers[i].winner = -1;
+    }
+    _front = 0;
+    _middle.store(1);
+    _back = 2;
+    _version = 0;
+}
+
+//  Return the buffer the writer fills with the next snapshot.  Only the
+//      writer may call this
+//  Parameters:
+//      none
+//  Returns:
+//      the buffer, holding some earlier snapshot
+//  Possible Errors:
+//      none
+BoardSnapshot& SnapshotSlot::Back() {
+    return _buffers[_back];
+}
+
+//  Make the snapshot in the back buffer the latest, dropping the latest
+//      one if the reader has not taken it.  Only the writer may call this
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SnapshotSlot::Publish() {
+    _buffers[_back].version = ++ _version;
+    _back = _middle.exchange(_back | FRESH, memory_order_acq_rel) & INDEX_MASK;
+}
+
+//  Bring the latest snapshot to the front if one was published since the
+//      last take.  Only the reader may call this
+//  Parameters:
+//      none
+//  Returns:
+//      true if the front holds a new snapshot
+//  Possible Errors:
+//      none
+bool SnapshotSlot::Take() {
+    if (0 == (_middle.load(memory_order_relaxed) & FRESH)) {
+        return false;
+    }
+    _front = _middle.exchange(_front, memory_order_acq_rel) & INDEX_MASK;
+    return true;
+}
+
+//  Return the snapshot taken last.  Only the reader may call this
+//  Parameters:
+//      none
+//  Returns:
+//      the snapshot, all zero before the first take
+//  Possible Errors:
+//      none
+const BoardSnapshot& SnapshotSlot::Front() const {
+    return _buffers[_front];
+}
@@ -0,0 +1,72 @@
+// Title: Lab 6 - boardSnapshot.h
+//
+// Purpose: Declares the BoardSnapshot, the state of a game being watched,
+//          and the SnapshotSlot that hands the latest snapshot of a game
+//          from the thread playing it to the thread showing it.
+//
+//          A slot is a triple buffer: the writer fills one buffer while
+//          the reader holds another, and the third holds the latest
+//          complete snapshot.  Publishing and taking each swap buffers with
+//          one atomic exchange, so neither side ever waits for the other.
+//          Snapshots the reader does not take in time are overwritten, so
+//          it only ever sees the latest one.  Each slot has one writer and
+//          one reader.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_BOARDSNAPSHOT_H
+#define BATTLESHIP_BOARDSNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include "boardMask.h"
+
+using namespace std;
+
+// State of a watched game
+//      version - number of snapshots published to the slot, this one included
+//      game - number of the game in its tournament
+//      games - games played in the slot so far, this one included
+//      shots - shots each player has fired
+//      winner - player who won, or -1 while the game goes on
+//      occupied, shot, sunk - per player, those squares of the grid the
+//          player fires at
+struct BoardSnapshot {
+    uint64_t version;
+    uint64_t game;
+    uint64_t games;
+    int shots[2];
+    int winner;
+    BoardMask occupied[2];
+    BoardMask shot[2];
+    BoardMask sunk[2];
+};
+
+//  Passes the latest snapshot of a game from one writer to one reader
+//      without locks
+class SnapshotSlot {
+public:
+    SnapshotSlot();
+
+    // Writer
+    BoardSnapshot& Back();
+    void Publish();
+
+    // Reader
+    bool Take();
+    const BoardSnapshot& Front() const;
+
+private:
+    // Index of a buffer and a flag set when it holds a snapshot not yet taken
+    static const uint8_t INDEX_MASK = 3;
+    static const uint8_t FRESH = 4;
+
+    BoardSnapshot _buffers[3];
+    atomic<uint8_t> _middle;
+    uint8_t _back;                  // owned by the writer
+    uint64_t _version;              // owned by the writer
+    uint8_t _front;                 // owned by the reader
+};
+
+#endif //BATTLESHIP_BOARDSNAPSHOT_H
@@ -0,0 +1,104 @@
+// Title: Lab 6 - buildBook.cpp
+//
+// Purpose: Build an opening book of the CPU's first shots for a roster of
+//          ships, see openingBook.h
+//
+//          Usage: BuildBook [-ships shipFile] [-depth shots] [-samples layouts] [-seed seed] output.book
+//
+//          The roster is the five classic ships unless a ship file in the
+//          format read by Grid::LoadShips is given, e.g. longShips.txt.
+//          Only the sizes of its ships are used.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "openingBook.h"
+
+//  Read the roster of ships from a ship file
+//  Parameters:
+//      fileName - name of the file
+//      ships - receives the ships
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be read, badly formed layout
+bool ReadRoster(const string& fileName, vector<Ship>& ships) {
+    ifstream file(fileName);
+    Grid grid(COUNT_ROWS, COUNT_COLUMNS, BOOK_SHIPS_MAX);
+
+    if (!file.is_open() || !grid.LoadShips(file)) {
+        return false;
+    }
+    ships.resize(grid.GetShipsDeployed());
+    for (int i = 0; i < grid.GetShipsDeployed(); i ++) {
+        grid.GetShip(i, ships[i]);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    vector<Ship> ships(CLASSIC_SHIPS, CLASSIC_SHIPS + CLASSIC_SHIP_COUNT);
+    OpeningBookBuilder builder;
+    string output;
+    int depth;
+    long samples;
+    uint64_t seed;
+    Rng rng;
+    chrono::steady_clock::time_point start;
+    chrono::duration<double> elapsed;
+
+    depth = BOOK_DEPTH_DEFAULT;
+    samples = BOOK_SAMPLES_DEFAULT;
+    seed = 1;
+    for (int i = 1; i < argc; i ++) {
+        string option = argv[i];
+
+        if (i + 1 < argc && "-ships" == option) {
+            if (!ReadRoster(argv[++i], ships)) {
+                cerr << "Cannot read ships from " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (i + 1 < argc && "-depth" == option) {
+            depth = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && "-samples" == option) {
+            samples = atol(argv[++i]);
+        }
+        else if (i + 1 < argc && "-seed" == option) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (i + 1 == argc && option[0] != '-') {
+            output = option;
+        }
+        else {
+            output.clear();
+            break;
+        }
+    }
+    if (output.empty()) {
+        cerr << "Usage: " << argv[0]
+             << " [-ships shipFile] [-depth shots] [-samples layouts] [-seed seed] output.book" << endl;
+        return 1;
+    }
+
+    start = chrono::steady_clock::now();
+    rng.Seed(seed);
+    if (!builder.Build(ships.data(), (int)ships.size(), rng, depth, samples)) {
+        cerr << "Cannot build a book " << depth << " shots deep from " << samples
+             << " layouts of these ships" << endl;
+        return 1;
+    }
+    if (!builder.Save(output)) {
+        cerr << "Cannot write " << output << endl;
+        return 1;
+    }
+    elapsed = chrono::steady_clock::now() - start;
+    cout << builder.GetNodeCount() << " nodes written to " << output
+         << " in " << elapsed.count() << " seconds" << endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+// Title: Lab 6 - cpulogic.cpp
+//
+// Purpose: Implements the CpuLogic class which decides where the CPU fires
+//          its next shot, based on the outcomes of its previous shots
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <assert.h>
+#include "cpulogic.h"
+#include "rng.h"
+
+//
+//  Constructor
+//  Parameters:
+//      useSolver - whether the endgame solver picks the shots late in the game
+//      ships - roster of ships the opponent has placed, only sizes are used
+//      shipCount - number of elements in ships, the solver is not used
+//          for more than SHIPS_MAX ships
+CpuLogic::CpuLogic(bool useSolver, const Ship ships[], int shipCount)
+        : _solver(ships, shipCount) {
+    _useSolver = useSolver && shipCount <= SHIPS_MAX;
+    _book = nullptr;
+    Init();
+}
+
+//  Forget everything learned, ready for a new game
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void CpuLogic::Init() {
+    for (int row = 0; row < COUNT_ROWS; row ++) {
+        for (int column = 0; column < COUNT_COLUMNS; column ++) {
+            _status[row][column] = UNKNOWN;
+        }
+    }
+    _targetCount = 0;
+    _misses = 0;
+    _hits = 0;
+    _sinks = 0;
+    _solver.Init();
+    _bookNode = _book ? 0 : -1;
+}
+
+//  Take the first shots of each game from an opening book.  The book must
+//      be for the roster of the opponent and stay open while it is used
+//  Parameters:
+//      book - the book, or nullptr for none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void CpuLogic::UseBook(const OpeningBook* book) {
+    _book = book && book->IsOpen() ? book : nullptr;
+    _bookNode = _book ? 0 : -1;
+}
+
+//  Decide where to fire the next shot
+//  Parameters:
+//      row - receives the row of the shot
+//      column - receives the column of the shot
+//      rng - random number generator to pick hunt squares with
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      must not be called once every square has been fired at
+void CpuLogic::DetermineShot(int& row, int& column, Rng& rng) {
+    int candidates[COUNT_SQUARES];
+    int count;
+
+    // Opening: the book's shot, while the game has followed the book
+    if (_bookNode >= 0) {
+        count = _book->GetSquare(_bookNode);
+        row = count / COUNT_COLUMNS;
+        column = count % COUNT_COLUMNS;
+        if (UNKNOWN == _status[row][column]) {
+            return;
+        }
+        _bookNode = -1;
+    }
+
+    // Endgame: the solver knows best once it can list the layouts left
+    if (_useSolver && _solver.Solve(_misses, _hits, _sinks, count)) {
+        row = count / COUNT_COLUMNS;
+        column = count % COUNT_COLUMNS;
+        return;
+    }
+
+    // Target mode: take the most recently queued neighbor of a hit
+    while (_targetCount > 0) {
+        int square;
+
+        square = _targets[--_targetCount];
+        row = square / COUNT_COLUMNS;
+        column = square % COUNT_COLUMNS;
+        if (UNKNOWN == _status[row][column]) {
+            return;
+        }
+    }
+
+    // Hunt mode: prefer unexplored squares on the checkerboard, fall back to any
+    count = 0;
+    for (int pass = 0; pass < 2 && 0 == count; pass ++) {
+        for (int r = 0; r < COUNT_ROWS; r ++) {
+            for (int c = 0; c < COUNT_COLUMNS; c ++) {
+                if (UNKNOWN == _status[r][c] && (pass == 1 || (r + c) % 2 == 0)) {
+                    candidates[count++] = r*COUNT_COLUMNS + c;
+                }
+            }
+        }
+    }
+    assert(count > 0);
+    count = candidates[rng.Below(count)];
+    row = count / COUNT_COLUMNS;
+    column = count % COUNT_COLUMNS;
+}
+
+//  Learn the outcome of a shot that was fired
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - what happened
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void CpuLogic::ReportOutcome(int row, int column, Outcome outcome) {
+    BoardMask square = (BoardMask)1 << (row*COUNT_COLUMNS + column);
+
+    if (_bookNode >= 0) {
+        _bookNode = row*COUNT_COLUMNS + column == _book->GetSquare(_bookNode)
+                    ? _book->GetNext(_bookNode, outcome) : -1;
+    }
+    switch (outcome) {
+        case SHOT_MISSED:
+            _status[row][column] = SHOT_MISS;
+            _misses |= square;
+            break;
+        case SHIP_HIT:
+            _status[row][column] = SHOT_HIT;
+            _hits |= square;
+            PushTarget(row-1, column);
+            PushTarget(row+1, column);
+            PushTarget(row, column-1);
+            PushTarget(row, column+1);
+            break;
+        case SHIP_SUNK:
+        case GAME_WON:
+            _status[row][column] = SHOT_HIT;
+            _hits |= square;
+            _sinks |= square;
+            // Keep the queue: it may hold the neighbors of another ship hit
+            // but not yet sunk, and DetermineShot skips any already fired at
+            break;
+        case SHOT_HERE_BEFORE:
+            break;
+    }
+}
+
+//  Queue a square adjacent to a hit to be fired at in target mode
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none, squares off the grid or already fired at are ignored
+void CpuLogic::PushTarget(int row, int column) {
+    if (row < 0 || row >= COUNT_ROWS || column < 0 || column >= COUNT_COLUMNS) {
+        return;
+    }
+    if (UNKNOWN == _status[row][column] && _targetCount < COUNT_SQUARES) {
+        _targets[_targetCount++] = row*COUNT_COLUMNS + column;
+    }
+}
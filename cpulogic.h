@@ -0,0 +1,68 @@
+// Title: Lab 6 - cpulogic.h
+//
+// Purpose: Declares the CpuLogic class which decides where the CPU fires
+//          its next shot, based on the outcomes of its previous shots
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_CPULOGIC_H
+#define BATTLESHIP_CPULOGIC_H
+
+#include "grid.h"
+#include "endgameSolver.h"
+#include "openingBook.h"
+
+//  Interface shared by the CPU shot strategies, so that the game and the
+//      simulator can use any of them
+class ShotStrategy {
+public:
+    virtual ~ShotStrategy() {}
+
+    virtual void Init() = 0;
+    virtual void DetermineShot(int& row, int& column, Rng& rng) = 0;
+    virtual void ReportOutcome(int row, int column, Outcome outcome) = 0;
+};
+
+// What the CPU knows about a square of its opponent's grid
+enum ShotStatus { UNKNOWN, SHOT_MISS, SHOT_HIT };
+
+//  Class implementing a hunt/target shot strategy
+//      In hunt mode it fires at random unexplored squares of one color of
+//      a checkerboard (every ship covers at least one of them).  After a hit
+//      it switches to target mode and works through the neighbors of the
+//      hit until the ship is sunk.  Late in the game, once few enough
+//      layouts of the ships are left, the endgame solver picks the shots.
+//      Given an opening book, the first shots come from the book for as
+//      long as the outcomes stay in it.  The solver needs the roster of
+//      the opponent's ships, the classic ships unless given.
+class CpuLogic : public ShotStrategy {
+public:
+    CpuLogic(bool useSolver = true, const Ship ships[] = CLASSIC_SHIPS, int shipCount = CLASSIC_SHIP_COUNT);
+
+    void Init() override;
+    void DetermineShot(int& row, int& column, Rng& rng) override;
+    void ReportOutcome(int row, int column, Outcome outcome) override;
+
+    void UseBook(const OpeningBook* book);
+
+private:
+    void PushTarget(int row, int column);
+
+    ShotStatus _status[COUNT_ROWS][COUNT_COLUMNS];
+    int _targets[COUNT_SQUARES];
+    int _targetCount;
+
+    // The shots as masks for the endgame solver
+    bool _useSolver;
+    BoardMask _misses;
+    BoardMask _hits;
+    BoardMask _sinks;
+    EndgameSolver _solver;
+
+    // Position in the opening book, -1 once out of it
+    const OpeningBook* _book;
+    int _bookNode;
+};
+
+#endif //BATTLESHIP_CPULOGIC_H
@@ -6,8 +6,11 @@
 // Class: CSC 2430 Winter 2020
 // Author: Max Benson
 
+#include <algorithm>
 #include <iostream>
 #include <assert.h>
+#include <poll.h>
+#include <unistd.h>
 #include "cursesWindow.h"
 
 //
@@ -18,6 +21,8 @@
 BaseWindow::BaseWindow(const string& name) {
     m_name = name;
     m_pwindow = nullptr;
+    m_parent = nullptr;
+    m_layoutValid = false;
 }
 
 //
@@ -29,6 +34,88 @@ BaseWindow::~BaseWindow() {
     }
 }
 
+//  Throw away the cached layout of this window and of every container it
+//      is in, so the next layout measures them again and arranges what
+//      moved.  Call after anything that changes the size of the window.
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void BaseWindow::InvalidateLayout() {
+    m_layoutValid = false;
+    if (m_parent) {
+        m_parent->InvalidateLayout();
+    }
+}
+
+//  Lay out and redraw every window after the terminal was resized.  The
+//      request is passed up to the main window, which does the work.
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void BaseWindow::HandleResize() {
+    if (m_parent) {
+        m_parent->HandleResize();
+    }
+}
+
+//  Return the file descriptor keys are read from.  The main window knows,
+//      so the request is passed up to it.
+//  Parameters:
+//      none
+//  Returns:
+//      the descriptor of the terminal's input
+//  Possible errors:
+//      none
+int BaseWindow::KeyDescriptor() {
+    return m_parent ? m_parent->KeyDescriptor() : STDIN_FILENO;
+}
+
+//  Bring the WINDOW to the position SetPosition gave the window and to
+//      the size it must have.  The WINDOW is moved and resized when ncurses
+//      can do that, and made anew otherwise or if there was none.  ncurses
+//      may have cut windows down when the terminal shrank, so the part of
+//      the old WINDOW still holding its cells is reported.
+//  Parameters:
+//      height - number of lines the WINDOW must have
+//      width - number of characters per line
+//      keptHeight - receives the number of lines whose cells were kept
+//      keptWidth - receives the number of characters per line kept
+//  Returns:
+//      success/failure
+//  Possible errors:
+//      the window does not fit on the terminal
+bool BaseWindow::PlaceWindow(int height, int width, int& keptHeight, int& keptWidth) {
+    keptHeight = 0;
+    keptWidth = 0;
+    if (m_pwindow) {
+        getmaxyx(m_pwindow, keptHeight, keptWidth);
+        if ((keptHeight != height || keptWidth != width) && ERR == wresize(m_pwindow, height, width)) {
+            delwin(m_pwindow);
+            m_pwindow = nullptr;
+        }
+        else if ((getbegy(m_pwindow) != m_yULWindow || getbegx(m_pwindow) != m_xULWindow)
+                 && ERR == mvwin(m_pwindow, m_yULWindow, m_xULWindow)) {
+            delwin(m_pwindow);
+            m_pwindow = nullptr;
+        }
+    }
+    if (nullptr == m_pwindow) {
+        keptHeight = 0;
+        keptWidth = 0;
+        m_pwindow = newwin(height, width, m_yULWindow, m_xULWindow);
+        return nullptr != m_pwindow;
+    }
+    keptHeight = min(keptHeight, height);
+    keptWidth = min(keptWidth, width);
+    return true;
+}
+
 //
 //  Class that windowing classes used for plotting or getting
 //      input are derived from.
@@ -51,6 +138,7 @@ Content::Content(const string& name) :
 void Content::SetPosition(int x, int y) {
     m_xULWindow = x;
     m_yULWindow = y;
+    m_layoutValid = true;
 }
 
 //
@@ -62,6 +150,9 @@ PlotWindow::PlotWindow(const string& name, int height, int width)
         : Content(name) {
     m_height = height;
     m_width = width;
+    m_cells.assign(height*width, ' ');
+    m_shown.assign(height*width, ' ');
+    m_background.assign(height*width, ' ');
 }
 
 //  Determine how many lines are required to display this window
@@ -90,7 +181,8 @@ int PlotWindow::RequiredWidth() {
 }
 
 //  Trigger the initial display of this window.  This includes
-//      creating an ncurses WINDOW and doing an initial refresh on it
+//      creating an ncurses WINDOW and doing an initial refresh on it.
+//      Anything written before this call is displayed now.
 //  Parameters:
 //      None
 //  Returns:
@@ -99,13 +191,87 @@ int PlotWindow::RequiredWidth() {
 //      none
 bool PlotWindow::Display() {
     m_pwindow = newwin(m_height, m_width, m_yULWindow, m_xULWindow);
-    wrefresh(m_pwindow);
+    m_shown.assign(m_height*m_width, ' ');
+    m_dirty.clear();
+    m_dirty.push_back({0, 0, m_width, m_height});
+    Refresh();
     return true;
 }
 
-//  Erase everything that is currently displayed.  This call must
-//    eventually be followed by a call on the Refresh method.  The
-//    typical call sequence for writing messages to a window is:
+//  Redraw the window after the terminal was resized, from the cells it
+//      holds.  The WINDOW is reused if it can be, and only cells it lost
+//      are sent again.  The WINDOW is refreshed for the next doupdate.
+//  Parameters:
+//      None
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void PlotWindow::Redisplay() {
+    vector<chtype> shown(m_height*m_width, ' ');
+    int keptHeight;
+    int keptWidth;
+
+    if (!PlaceWindow(m_height, m_width, keptHeight, keptWidth)) {
+        return;
+    }
+    for (int y = 0; y < keptHeight; y ++) {
+        for (int x = 0; x < keptWidth; x ++) {
+            shown[y*m_width + x] = m_shown[y*m_width + x];
+        }
+    }
+    m_shown.swap(shown);
+    m_dirty.clear();
+    m_dirty.push_back({0, 0, m_width, m_height});
+    SendDirty();
+    touchwin(m_pwindow);
+    wnoutrefresh(m_pwindow);
+}
+
+//  Change the size of the window, keeping the cells that are inside both
+//      the old and the new size.  The containers the window is in are laid
+//      out again the next time the main window is.
+//  Parameters:
+//      height - new number of lines
+//      width - new number of characters per line
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void PlotWindow::Resize(int height, int width) {
+    vector<chtype> cells(height*width, ' ');
+    vector<chtype> shown(height*width, ' ');
+    vector<chtype> background(height*width, ' ');
+
+    if (height == m_height && width == m_width) {
+        return;
+    }
+    for (int y = 0; y < height && y < m_height; y ++) {
+        for (int x = 0; x < width && x < m_width; x ++) {
+            cells[y*width + x] = m_cells[y*m_width + x];
+            shown[y*width + x] = m_shown[y*m_width + x];
+            background[y*width + x] = m_background[y*m_width + x];
+        }
+    }
+    m_height = height;
+    m_width = width;
+    m_cells.swap(cells);
+    m_shown.swap(shown);
+    m_background.swap(background);
+    m_dirty.clear();
+    m_dirty.push_back({0, 0, m_width, m_height});
+
+    // ncurses keeps the cells inside both sizes and blanks the rest, as m_shown does
+    if (m_pwindow) {
+        wresize(m_pwindow, m_height, m_width);
+    }
+    InvalidateLayout();
+}
+
+//  Erase everything that is currently displayed, going back to the
+//    background saved by SaveBackground (blank if never saved).  This
+//    call must eventually be followed by a call on the Refresh method.
+//    The typical call sequence for writing messages to a window is:
 //          Erase
 //          Write
 //          Refresh
@@ -117,7 +283,24 @@ bool PlotWindow::Display() {
 //  Possible errors:
 //      none
 void PlotWindow::Erase() {
-    wclear(m_pwindow);
+    for (int y = 0; y < m_height; y ++) {
+        for (int x = 0; x < m_width; x ++) {
+            SetCell(x, y, m_background[y*m_width + x]);
+        }
+    }
+}
+
+//  Remember what has been written so far as the background that Erase
+//      goes back to.  Content that never changes, such as grid lines,
+//      is then drawn once and never sent again.
+//  Parameters:
+//      None
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void PlotWindow::SaveBackground() {
+    m_background = m_cells;
 }
 
 //  Plot the character ch at position (x,y) with the specified
@@ -140,24 +323,9 @@ void PlotWindow::Erase() {
 //  Returns:
 //      nothing
 //  Possible errors:
-//      none
+//      positions outside the window are ignored
 void PlotWindow::Write(int x, int y, chtype ch, int color, int attrib) {
-    int effectiveAttrib;
-
-    effectiveAttrib = 0;
-    if (attrib != A_NORMAL) {
-        effectiveAttrib |= attrib;
-    }
-    if (color != DEFAULT_COLOR) {
-        effectiveAttrib |= COLOR_PAIR(color);
-    }
-    if (effectiveAttrib != 0) {
-        wattron(m_pwindow, effectiveAttrib);
-    }
-    mvwaddch(m_pwindow, y, x, ch);
-    if (effectiveAttrib != 0) {
-        wattroff(m_pwindow, effectiveAttrib);
-    }
+    SetCell(x, y, MakeCell(ch, color, attrib));
 }
 
 //  Write the text string horizontally starting at position (x,y) with the specified
@@ -178,37 +346,210 @@ void PlotWindow::Write(int x, int y, chtype ch, int color, int attrib) {
 //  Returns:
 //      nothing
 //  Possible errors:
-//      none
+//      text past the right edge of the window is cut off
 void PlotWindow::Write(int x, int y, const string& text, int color, int attrib) {
-    int effectiveAttrib;
+    chtype effectiveAttrib;
+
+    effectiveAttrib = MakeCell(0, color, attrib);
+    for (size_t i = 0; i < text.length(); i ++) {
+        SetCell(x + (int)i, y, (unsigned char)text[i] | effectiveAttrib);
+    }
+}
+
+//  Write a run of cells horizontally starting at position (x,y).  Each
+//      cell carries its own color and attribute (see MakeCell), so a row
+//      mixing colors is written with one call.  This call must eventually
+//      be followed by a call on the Refresh method.
+//  Parameters:
+//      x - x-coordinate of the first cell
+//      y - y-coordinate of the cells
+//      cells - characters with their attribute bits
+//      count - number of cells
+//  Returns:
+//      nothing
+//  Possible errors:
+//      cells outside the window are ignored
+void PlotWindow::WriteRun(int x, int y, const chtype cells[], int count) {
+    for (int i = 0; i < count; i ++) {
+        SetCell(x + i, y, cells[i]);
+    }
+}
 
-    effectiveAttrib = 0;
+//  Combine a character with a color pair index and character attribute
+//      into the cell stored by the window
+//  Parameters:
+//      ch - character (may be extended character)
+//      color - index of color pair to use
+//      attrib - optional character attribute
+//  Returns:
+//      the cell
+//  Possible errors:
+//      none
+chtype PlotWindow::MakeCell(chtype ch, int color, int attrib) {
+    chtype cell;
+
+    cell = ch;
     if (attrib != A_NORMAL) {
-        effectiveAttrib |= attrib;
+        cell |= attrib;
     }
     if (color != DEFAULT_COLOR) {
-        effectiveAttrib |= COLOR_PAIR(color);
+        cell |= COLOR_PAIR(color);
     }
-    if (effectiveAttrib != 0) {
-        wattron(m_pwindow, effectiveAttrib);
+    return cell;
+}
+
+//  Send the cells changed since the last Refresh call to the WINDOW and
+//      redraw it.  Only cells inside a dirty rectangle that differ from
+//      what was last sent are written, and changed cells on a row that
+//      are at most RUN_GAP_MAX apart go out as one run.  You get better
+//      performance by batching Write calls before calling Refresh.
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void PlotWindow::Refresh() {
+    if (nullptr == m_pwindow) {
+        return;
     }
-    mvwprintw(m_pwindow, y, x, text.c_str());
-    if (effectiveAttrib != 0) {
-        wattroff(m_pwindow, effectiveAttrib);
+    if (SendDirty()) {
+        wrefresh(m_pwindow);
     }
 }
 
-//  Redraw the window including all changes to the WINDOW made since
-//      the last Refresh call. You get better performance by batching
-//      Write calls before calling Refresh.
+//  Like Refresh, but the WINDOW only goes to the terminal with the next
+//      MainWindow::Update, so many windows can be drawn in one update
 //  Parameters:
 //      none
 //  Returns:
 //      nothing
 //  Possible errors:
 //      none
-void PlotWindow::Refresh() {
-    wrefresh(m_pwindow);
+void PlotWindow::RefreshLater() {
+    if (nullptr == m_pwindow) {
+        return;
+    }
+    if (SendDirty()) {
+        wnoutrefresh(m_pwindow);
+    }
+}
+
+//  Send the dirty cells that differ from what was last sent to the WINDOW,
+//      without refreshing it
+//  Parameters:
+//      none
+//  Returns:
+//      whether any cell was sent
+//  Possible errors:
+//      none
+bool PlotWindow::SendDirty() {
+    bool changed;
+
+    changed = false;
+    for (const DirtyRect& rect : m_dirty) {
+        for (int y = rect.top; y < rect.bottom; y ++) {
+            int runStart = -1;
+            int lastChanged = -1;
+
+            for (int x = rect.left; x < rect.right; x ++) {
+                int i = y*m_width + x;
+
+                if (m_cells[i] != m_shown[i]) {
+                    if (runStart < 0) {
+                        runStart = x;
+                    }
+                    lastChanged = x;
+                }
+                else if (runStart >= 0 && x - lastChanged > RUN_GAP_MAX) {
+                    SendRun(y, runStart, lastChanged + 1);
+                    runStart = -1;
+                }
+            }
+            if (runStart >= 0) {
+                SendRun(y, runStart, lastChanged + 1);
+            }
+            changed |= lastChanged >= 0;
+        }
+    }
+    m_dirty.clear();
+    return changed;
+}
+
+//  Send a run of cells on one row to the WINDOW
+//  Parameters:
+//      y - y-coordinate of the row
+//      left - x-coordinate of the first cell
+//      right - x-coordinate just past the last cell
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void PlotWindow::SendRun(int y, int left, int right) {
+    int i = y*m_width + left;
+
+    mvwaddchnstr(m_pwindow, y, left, &m_cells[i], right - left);
+    copy(m_cells.begin() + i, m_cells.begin() + i + (right - left), m_shown.begin() + i);
+}
+
+//  Store a cell in the shadow buffer, marking it dirty if it changed
+//  Parameters:
+//      x - x-coordinate of the cell
+//      y - y-coordinate of the cell
+//      cell - character with its attribute bits
+//  Returns:
+//      nothing
+//  Possible errors:
+//      positions outside the window are ignored
+void PlotWindow::SetCell(int x, int y, chtype cell) {
+    int i;
+
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+        return;
+    }
+    i = y*m_width + x;
+    if (m_cells[i] != cell) {
+        m_cells[i] = cell;
+        MarkDirty(x, y);
+    }
+}
+
+//  Add a cell to the dirty rectangles.  A rectangle that already holds
+//      the cell or touches it grows to take it in, otherwise a new one is
+//      started.  When there are too many rectangles they are merged into
+//      their bounding box.
+//  Parameters:
+//      x - x-coordinate of the cell
+//      y - y-coordinate of the cell
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void PlotWindow::MarkDirty(int x, int y) {
+    DirtyRect bounds;
+
+    for (DirtyRect& rect : m_dirty) {
+        if (x >= rect.left - 1 && x <= rect.right && y >= rect.top - 1 && y <= rect.bottom) {
+            rect.left = min(rect.left, x);
+            rect.top = min(rect.top, y);
+            rect.right = max(rect.right, x + 1);
+            rect.bottom = max(rect.bottom, y + 1);
+            return;
+        }
+    }
+    if ((int)m_dirty.size() < DIRTY_RECTS_MAX) {
+        m_dirty.push_back({x, y, x + 1, y + 1});
+        return;
+    }
+    bounds = {x, y, x + 1, y + 1};
+    for (const DirtyRect& rect : m_dirty) {
+        bounds.left = min(bounds.left, rect.left);
+        bounds.top = min(bounds.top, rect.top);
+        bounds.right = max(bounds.right, rect.right);
+        bounds.bottom = max(bounds.bottom, rect.bottom);
+    }
+    m_dirty.clear();
+    m_dirty.push_back(bounds);
 }
 
 //
@@ -219,50 +560,89 @@ void PlotWindow::Refresh() {
 //  Constructor
 InputWindow::InputWindow(const string& name, int requiredWidth)
         : Content(name) {
-    keypad(m_pwindow,true);
     m_requiredWidth = requiredWidth;
 }
 
+//  Start a new line of input
+//      Erases the window
+//      Positions the cursor at the upper left hand corner of the window
+//      Refreshes the window
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void InputWindow::StartInput() {
+    m_input.clear();
+    if (m_pwindow) {
+        werase(m_pwindow);
+        wmove(m_pwindow, 0, 0);
+        wrefresh(m_pwindow);
+    }
+}
+
+//  Handle the keys typed since the last call, waiting for one for at most
+//      a given time if none has been typed.  The wait is a poll of the
+//      terminal's input, so a resize of the terminal ends it too.  The
+//      window is refreshed once after all the keys waiting are handled
+//  Parameters:
+//      milliseconds - longest time to wait, 0 not to wait, or negative
+//          to wait until a key comes
+//      line - receives the line once ENTER is typed
+//  Returns:
+//      true if the line was finished, false if it is still being typed
+//  Possible errors:
+//      none
+bool InputWindow::PollInput(int milliseconds, string& line) {
+    struct pollfd keys;
+    bool finished;
+    int ch;
+
+    wtimeout(KeyWindow(), 0);
+    ch = wgetch(KeyWindow());
+    if (ERR == ch && 0 != milliseconds) {
+        keys.fd = KeyDescriptor();
+        keys.events = POLLIN;
+        keys.revents = 0;
+        poll(&keys, 1, milliseconds);
+        ch = wgetch(KeyWindow());
+    }
+    finished = false;
+    while (ERR != ch && !finished) {
+        finished = EditLine(ch);
+        if (!finished) {
+            ch = wgetch(KeyWindow());
+        }
+    }
+    if (m_pwindow) {
+        wrefresh(m_pwindow);
+    }
+    if (finished) {
+        line = m_input;
+    }
+    return finished;
+}
+
 //  Get the line of input that the user types
-//      First:
-//          Erases the window
-//          Positions the cursor at the upper left hand corner of the window
-//          Refreshes the window
-//      Then gets the characters as the user types them building a string from them
-//      This function has the logic to handle the user typing BACKSPACE
+//      Starts a new line, then handles the keys as the user types them
+//      until ENTER, waiting for each in PollInput
 //  Parameters:
 //      none
 //  Returns:
 //      a string built from what the user types
+//      When the terminal is resized every window is laid out and redrawn
+//      and the input goes on.
 //  Possible errors:
-//      Does not handle other keys.  Returned string may contain unexpected characters
-//      when use types special keys on the keyboard
+//      Keys other than printable characters, BACKSPACE and ENTER are
+//      ignored
 string InputWindow::GetInput() {
-    char ch;
-    int pos;
-    string input;
+    string line;
 
-    werase(m_pwindow);
-    wmove(m_pwindow, 0, 0);
-    wrefresh(m_pwindow);
-    pos = 0;
-    while ((ch = wgetch(m_pwindow)) != '\n') {
-        if (isprint(ch)) {
-            input += ch;
-            pos ++;
-        }
-        else {
-            if ('\177' == ch) {    //Backspace
-                input = input.substr(0, --pos);
-            }
-            wclear(m_pwindow);
-            mvwprintw(m_pwindow, 0, 0, "%s", input.c_str());
-            wrefresh(m_pwindow);
-        }
+    StartInput();
+    while (!PollInput(-1, line)) {
     }
-    wmove(m_pwindow, 0, pos);
-    wrefresh(m_pwindow);
-    return input;
+    return line;
 }
 
 //  Determine how many lines are required to display this window
@@ -301,10 +681,86 @@ int InputWindow::RequiredWidth() {
 //      none
 bool InputWindow::Display() {
     m_pwindow = newwin(1, m_requiredWidth, m_yULWindow, m_xULWindow);
+    keypad(m_pwindow, true);
     wrefresh(m_pwindow);
     return true;
 }
 
+//  Bring the window back after the terminal was resized, with what has
+//      been typed so far.  The WINDOW is refreshed for the next doupdate.
+//  Parameters:
+//      None
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void InputWindow::Redisplay() {
+    int keptHeight;
+    int keptWidth;
+
+    if (!PlaceWindow(1, m_requiredWidth, keptHeight, keptWidth)) {
+        return;
+    }
+    if (0 == keptHeight) {
+        keypad(m_pwindow, true);
+    }
+    if (keptWidth < (int)m_input.length()) {
+        mvwprintw(m_pwindow, 0, 0, "%s", m_input.c_str());
+    }
+    wmove(m_pwindow, 0, (int)m_input.length());
+    touchwin(m_pwindow);
+    wnoutrefresh(m_pwindow);
+}
+
+//  Return the WINDOW keys are read from: this window, or the whole screen
+//      while the terminal is too small to show it
+//  Parameters:
+//      None
+//  Returns:
+//      the WINDOW
+//  Possible errors:
+//      none
+WINDOW* InputWindow::KeyWindow() {
+    return m_pwindow ? m_pwindow : stdscr;
+}
+
+//  Apply a key to the line being typed, drawing only what it changes: a
+//      character is added at the end, BACKSPACE blanks the last one.  The
+//      line stops at the width of the window
+//  Parameters:
+//      ch - the key
+//  Returns:
+//      true if the key was ENTER, which finishes the line
+//  Possible errors:
+//      none
+bool InputWindow::EditLine(int ch) {
+    int pos = (int)m_input.length();
+
+    if ('\n' == ch || '\r' == ch || KEY_ENTER == ch) {
+        return true;
+    }
+    if (KEY_RESIZE == ch) {
+        // The resize redraws every window, this one with the input
+        HandleResize();
+    }
+    else if (ch < KEY_MIN && isprint(ch)) {
+        if (pos < m_requiredWidth - 1) {
+            m_input += (char)ch;
+            if (m_pwindow) {
+                mvwaddch(m_pwindow, 0, pos, ch);
+            }
+        }
+    }
+    else if (('\177' == ch || '\b' == ch || KEY_BACKSPACE == ch) && pos > 0) {
+        m_input.erase(-- pos);
+        if (m_pwindow) {
+            mvwaddch(m_pwindow, 0, pos, ' ');
+            wmove(m_pwindow, 0, pos);
+        }
+    }
+    return false;
+}
+
 //
 //  Class that windowing classes used grouping windows
 //      horizontally (HGroup) or vertically (VGroup)
@@ -347,6 +803,22 @@ Container::Container(const string& name,
 //      none
 void Container::AddChild(BaseWindow *child) {
     m_children.push_back(child);
+    child->m_parent = this;
+    InvalidateLayout();
+}
+
+//  Throw away the cached sizes of this container as well as its layout,
+//      and those of the containers it is in
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void Container::InvalidateLayout() {
+    m_heightCached = false;
+    m_widthCached = false;
+    BaseWindow::InvalidateLayout();
 }
 
 //  Save the position of the container with respect to the main window
@@ -432,8 +904,55 @@ void Container::SetPosition(int x, int y) {
 //      unexpected, but theoretically it could return false if there was a problem
 //      displaying a child window
 bool Container::Display() {
-    // Create window and display border if desired
+    // Create window and display border and titles
     m_pwindow = newwin(m_windowHeight, m_windowWidth, m_yULWindow, m_xULWindow);
+    DrawFrame();
+    wrefresh(m_pwindow);
+
+    // Show my children
+    for (int i = 0; i < m_children.size(); i ++) {
+        if (!m_children[i]->Display()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Redraw the container and its child windows after the terminal was
+//      resized.  The WINDOWs are reused if they can be, and the border and
+//      titles are drawn again only if the WINDOW lost them.  The WINDOWs
+//      are refreshed for the next doupdate.
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Container::Redisplay() {
+    int keptHeight;
+    int keptWidth;
+
+    if (PlaceWindow(m_windowHeight, m_windowWidth, keptHeight, keptWidth)) {
+        if (keptHeight != m_windowHeight || keptWidth != m_windowWidth) {
+            werase(m_pwindow);
+            DrawFrame();
+        }
+        touchwin(m_pwindow);
+        wnoutrefresh(m_pwindow);
+    }
+    for (size_t i = 0; i < m_children.size(); i ++) {
+        m_children[i]->Redisplay();
+    }
+}
+
+//  Draw the border, if desired, and the titles of the container
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Container::DrawFrame() {
     if (m_hasBorder) {
         box(m_pwindow, ACS_VLINE, ACS_HLINE);
     }
@@ -473,16 +992,6 @@ bool Container::Display() {
             wattroff(m_pwindow, m_vTitleAttrib);
         }
     }
-
-    wrefresh(m_pwindow);
-
-    // Show my children
-    for (int i = 0; i < m_children.size(); i ++) {
-        if (!m_children[i]->Display()) {
-            return false;
-        }
-    }
-    return true;
 }
 
 //
@@ -602,6 +1111,11 @@ int HGroup::RequiredWidth() {
 void HGroup::SetPosition(int x, int y) {
     int xChild;
 
+    // Nothing inside has changed size since it was arranged here
+    if (m_layoutValid && x == m_xULWindow && y == m_yULWindow) {
+        return;
+    }
+
     // Figure out the coordinates of the child area
     Container::SetPosition(x, y);
 
@@ -611,6 +1125,7 @@ void HGroup::SetPosition(int x, int y) {
         m_children[i]->SetPosition(xChild, m_yTopChildren + m_yULWindow);
         xChild += m_children[i]->RequiredWidth();
     }
+    m_layoutValid = true;
 }
 
 //
@@ -729,6 +1244,11 @@ int VGroup::RequiredWidth() {
 void VGroup::SetPosition(int x, int y) {
     int yChild;
 
+    // Nothing inside has changed size since it was arranged here
+    if (m_layoutValid && x == m_xULWindow && y == m_yULWindow) {
+        return;
+    }
+
     // Figure out the coordinates of the child area
     Container::SetPosition(x, y);
 
@@ -738,6 +1258,7 @@ void VGroup::SetPosition(int x, int y) {
         m_children[i]->SetPosition(m_xLeftChildren + m_xULWindow, yChild);
         yChild += m_children[i]->RequiredHeight();
     }
+    m_layoutValid = true;
 }
 
 //
@@ -753,20 +1274,71 @@ MainWindow::MainWindow(bool hasBorder, const string& hTitle, const string& vTitl
                        int hTitleAttrib, int vTitleAttrib)
         : VGroup("MainWindow", hasBorder, hTitle, vTitle, hTitlePosition, vTitlePosition,
                  hTitleColor, vTitleColor, hTitleAttrib, vTitleAttrib) {
-
+    m_screen = nullptr;
+    m_keyDescriptor = STDIN_FILENO;
 }
 
 //
 //  Destructor
+//      A terminal set by UseTerminal is deleted along with the windows
+//      still on it, so this window's own WINDOW is freed first
 MainWindow::~MainWindow() {
+    if (m_screen) {
+        if (m_pwindow) {
+            delwin(m_pwindow);
+            m_pwindow = nullptr;
+        }
+        set_term(m_screen);
+        endwin();
+        delscreen(m_screen);
+        return;
+    }
     endwin();
 }
 
+//  Display on a terminal other than the one the program was started in,
+//      e.g. a pipe or pseudo-terminal to measure the output.  Must be
+//      called before Display, which then draws there instead of calling
+//      initscr.  The subwindows must be destroyed before this window
+//  Parameters:
+//      type - terminal type, e.g. "xterm"
+//      output - stream written to draw on the terminal
+//      input - stream keys are read from
+//  Returns:
+//      success/failure
+//  Possible errors:
+//      unknown terminal type, terminal already set
+bool MainWindow::UseTerminal(const string& type, FILE* output, FILE* input) {
+    if (m_screen) {
+        return false;
+    }
+    m_screen = newterm(type.c_str(), output, input);
+    m_keyDescriptor = fileno(input);
+    return nullptr != m_screen;
+}
+
+//  Lay out the main window and its subwindows: measure them and tell them
+//      where they are.  Only the windows whose layout was invalidated since
+//      the last layout are measured again, and only those that changed size
+//      or moved are arranged again.
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void MainWindow::Layout() {
+    RequiredHeight();
+    RequiredWidth();
+    SetPosition(0, 0);
+}
+
 //  Displays the main window and its subwindows
 //      Follows the sequence
-//          Initialize ncurses including creating the color pairs
-//          Find required height and width
-//          Set positions of the subwindows
+//          Initialize ncurses, on the terminal set by UseTerminal if any,
+//              including creating the color pairs
+//          Find required height and width and set positions of the subwindows
+//          If the terminal is too small say so, HandleResize displays later
 //          Create the WINDOWs and display
 //  Parameters:
 //       fgColors - array of foreground colors
@@ -777,36 +1349,121 @@ MainWindow::~MainWindow() {
 //  Possible errors:
 //       none expected
 bool MainWindow::Display(int fgColors[], int bgColors[], int numberColorPairs) {
-    int height;
-    int width;
-    int heightAvail;
-    int widthAvail;
-    int line;
+    if (nullptr == m_screen) {
+        initscr();
+    }
+    else {
+        set_term(m_screen);
+    }
 
-    initscr();
+    // Keys come one at a time and InputWindow draws them itself, even when
+    // the input window is only displayed after the terminal grows
+    cbreak();
+    noecho();
     refresh();      // a refresh before creating subwindows appears to be necessary
     start_color();
     for (int i = 0; i < numberColorPairs; i ++) {
         init_pair(i+1,fgColors[i], bgColors[i]);
     }
 
-    // Find how big this window must be
-    height = RequiredHeight();
-    width = RequiredWidth();
+    // Find how big the windows must be and tell them where they start
+    Layout();
 
-    // Check with ncurses to see how much room we have
-    //getmaxyx(stdscr, heightAvail, widthAvail);
-    //if (height > heightAvail || width > widthAvail) {
-    //    cerr << "Initialization failed, try resizing the command window to size ";
-    //    cerr << height << " rows by " << width << " columns." << endl;
-    //    return false;
-    //}
-
-    // Now tell the subwindows where they start
-    SetPosition(0,0);
+    // Without room for the windows, wait for the terminal to be resized
+    keypad(stdscr, true);
+    if (ShowIfTooSmall()) {
+        return true;
+    }
 
     // Display the containers
     return Container::Display();
 }
 
+//  Lay out and redraw every window after the terminal was resized, in one
+//      frame.  The windows keep their WINDOWs and what they hold, so only
+//      what ncurses cut off when the terminal shrank is drawn again.
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void MainWindow::HandleResize() {
+    Layout();
+    if (ShowIfTooSmall()) {
+        return;
+    }
+    werase(stdscr);
+    wnoutrefresh(stdscr);
+    Redisplay();
+    clearok(curscr, true);
+    doupdate();
+}
+
+//  Return the file descriptor keys are read from: the input of the
+//      terminal given to UseTerminal, or standard input
+//  Parameters:
+//      none
+//  Returns:
+//      the descriptor
+//  Possible errors:
+//      none
+int MainWindow::KeyDescriptor() {
+    return m_keyDescriptor;
+}
+
+//  Send the windows refreshed with PlotWindow::RefreshLater to the
+//      terminal, all in one update
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible errors:
+//      none
+void MainWindow::Update() {
+    doupdate();
+}
+
+//  Wait for a key, for at most a given time.  A resize of the terminal
+//      is handled before the key is returned
+//  Parameters:
+//      milliseconds - longest time to wait, or negative to wait for a key
+//  Returns:
+//      the key, KEY_RESIZE after a resize or ERR if no key came in time
+//  Possible errors:
+//      none
+int MainWindow::GetKey(int milliseconds) {
+    int ch;
+
+    wtimeout(stdscr, milliseconds);
+    ch = wgetch(stdscr);
+    if (KEY_RESIZE == ch) {
+        HandleResize();
+    }
+    return ch;
+}
+
+//  If the terminal is too small for the windows, say on it how big it
+//      has to be
+//  Parameters:
+//      none
+//  Returns:
+//      true if the terminal is too small
+//  Possible errors:
+//      none
+bool MainWindow::ShowIfTooSmall() {
+    int heightAvail;
+    int widthAvail;
+
+    getmaxyx(stdscr, heightAvail, widthAvail);
+    if (m_windowHeight <= heightAvail && m_windowWidth <= widthAvail) {
+        return false;
+    }
+    werase(stdscr);
+    mvwprintw(stdscr, 0, 0, "Make the terminal at least %d rows by %d columns", m_windowHeight, m_windowWidth);
+    clearok(curscr, true);
+    wrefresh(stdscr);
+    return true;
+}
+
 
@@ -21,12 +21,43 @@ using namespace std;
 const int DEFAULT_COLOR = 0;
 enum TextPosition { LEFT, HIGH, CENTER, RIGHT, LOW };
 
+// Number of dirty rectangles a PlotWindow tracks before merging
+// them all into their bounding box
+const int DIRTY_RECTS_MAX = 8;
+
+// Unchanged cells a PlotWindow rewrites rather than splitting a run
+const int RUN_GAP_MAX = 4;
+
+//
+//  Rectangle of cells, left/top inclusive and right/bottom exclusive
+//
+struct DirtyRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+class Container;
+
 //
 //  Base windowing class for all the other windowing classes
 //      Holds the ncurses WINDOW handle and
 //      coordinates of upper left hand corner
 //      of the WINDOW with respect to its parent
 //
+//  Layout takes two passes, both cached: RequiredHeight and
+//      RequiredWidth measure the windows bottom up, then SetPosition
+//      arranges them top down.  A change to the size of a window is
+//      reported with InvalidateLayout, which throws away the cached
+//      layout of the window and of the containers it is in, so the
+//      next layout measures only those again and arranges only the
+//      windows that changed or moved.
+//
+//  When the terminal is resized the windows are laid out again and
+//      Redisplay brings the existing WINDOWs to their places and
+//      redraws them from what they hold, so the resize costs one frame.
+//
 //  Tree of subclasses derived from BaseWindow:
 //
 //                          BaseWindow
@@ -46,16 +77,25 @@ public:
     BaseWindow(const string& name);
     ~BaseWindow();
 
+    virtual void InvalidateLayout();
+    virtual void HandleResize();
+    virtual int KeyDescriptor();
+
 protected:
     virtual int RequiredHeight() = 0;
     virtual int RequiredWidth() = 0;
     virtual void SetPosition(int x, int y) = 0;
     virtual bool Display() = 0;
+    virtual void Redisplay() = 0;
+
+    bool PlaceWindow(int height, int width, int& keptHeight, int& keptWidth);
 
     int  m_xULWindow;               //Init by SetPosition
     int  m_yULWindow;               //Init by SetPosition
     WINDOW *m_pwindow;
     string m_name;
+    Container *m_parent;            //Init by Container::AddChild
+    bool m_layoutValid;             //Set by SetPosition, cleared by InvalidateLayout
 };
 
 //
@@ -72,42 +112,74 @@ protected:
 
 //
 //  Windowing class for writing text at a particular position
+//      Writes go to a shadow buffer of cells and the cells that
+//      change are recorded as dirty rectangles.  Refresh only
+//      sends the dirty cells that differ from what was last
+//      sent, so redrawing unchanged content costs no output.
+//      Runs of changed cells along a row go out in one call.
 //
 class PlotWindow : public Content {
 public:
     PlotWindow(const string& name, int height, int width);
 
+    void Resize(int height, int width);
     void Erase();
+    void SaveBackground();
     void Write(int x, int y, chtype ch, int color = DEFAULT_COLOR, int attrib = A_NORMAL);
     void Write(int x, int y, const string& text, int color = DEFAULT_COLOR, int attrib = A_NORMAL);
+    void WriteRun(int x, int y, const chtype cells[], int count);
     void Refresh();
+    void RefreshLater();
+
+    static chtype MakeCell(chtype ch, int color = DEFAULT_COLOR, int attrib = A_NORMAL);
 
 protected:
     int RequiredHeight() override;
     int RequiredWidth() override;
     bool Display() override;
+    void Redisplay() override;
 
 private:
+    bool SendDirty();
+    void SendRun(int y, int left, int right);
+    void SetCell(int x, int y, chtype cell);
+    void MarkDirty(int x, int y);
+
     int m_height;
     int m_width;
+
+    vector<chtype> m_cells;          // What the window should show
+    vector<chtype> m_shown;          // What was last sent to the WINDOW
+    vector<chtype> m_background;     // What Erase restores
+    vector<DirtyRect> m_dirty;       // Cells changed since last Refresh
 };
 
 //
 //  Windowing class for getting input
+//      Keys are read as they are typed, without blocking, and the
+//      line is edited in place: only the characters after the change
+//      are drawn again.
 //
 class InputWindow : public Content {
 public:
     InputWindow(const string& name, int requiredWidth);
 
+    void StartInput();
+    bool PollInput(int milliseconds, string& line);
     string GetInput();
 
 protected:
     int RequiredHeight() override;
     int RequiredWidth() override;
     bool Display() override;
+    void Redisplay() override;
 
 private:
+    WINDOW* KeyWindow();
+    bool EditLine(int ch);
+
     int m_requiredWidth;
+    string m_input;                 //What has been typed since StartInput
 
     string m_template;
 };
@@ -130,10 +202,13 @@ public:
               int hTitleAttrib = A_NORMAL, int vTitleAttrib = A_NORMAL );
 
     void AddChild(BaseWindow *child);
+    void InvalidateLayout() override;
     bool Display() override;
 
 protected:
     void SetPosition(int x, int y) override;
+    void Redisplay() override;
+    void DrawFrame();
 
     // Init by RequiredHeight
     bool m_heightCached;
@@ -213,7 +288,19 @@ public:
 
     ~MainWindow();
 
+    bool UseTerminal(const string& type, FILE* output, FILE* input);
+    void Layout();
     bool Display(int fgColors[], int bgColors[], int numberColorPairs);
+    void HandleResize() override;
+    int KeyDescriptor() override;
+    void Update();
+    int GetKey(int milliseconds);
+
+private:
+    bool ShowIfTooSmall();
+
+    SCREEN* m_screen;               //Init by UseTerminal, else ncurses' own
+    int m_keyDescriptor;            //Init by UseTerminal, else standard input
 };
 
 #endif //BATTLESHIP_CURSESWINDOW_H
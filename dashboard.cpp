@@ -0,0 +1,169 @@
+// Title: Lab 6 - dashboard.cpp
+//
+// Purpose: Implements the Dashboard class declared in dashboard.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include "dashboard.h"
+
+//
+//  Constructor
+//      boards tiles, columns of them per row
+Dashboard::Dashboard(int boards, int columns) :
+        _mainWindow(true, "BATTLESHIP DASHBOARD", "", CENTER, CENTER,
+                    DEFAULT_COLOR, DEFAULT_COLOR, A_STANDOUT),
+        _rows((boards + columns - 1) / columns, HGroup("Row")),
+        _tiles(boards, VGroup("Tile", true)),
+        _plots(boards, PlotWindow("Board", TILE_HEIGHT, TILE_WIDTH)),
+        _status("Status", 1, DASHBOARD_STATUS_WIDTH) {
+
+    // The containers hold pointers, so the vectors are never resized after this
+    for (int i = 0; i < boards; i ++) {
+        _tiles[i].AddChild(&_plots[i]);
+        _rows[i / columns].AddChild(&_tiles[i]);
+    }
+    for (HGroup& row : _rows) {
+        _mainWindow.AddChild(&row);
+    }
+    _mainWindow.AddChild(&_status);
+}
+
+//  Show the dashboard on a terminal other than the one the program was
+//      started in, see MainWindow::UseTerminal
+//  Parameters:
+//      type - terminal type, e.g. "xterm"
+//      output - stream written to draw on the terminal
+//      input - stream keys are read from
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      unknown terminal type
+bool Dashboard::UseTerminal(const string& type, FILE* output, FILE* input) {
+    return _mainWindow.UseTerminal(type, output, input);
+}
+
+//  Bring up the dashboard with every board empty
+//  Parameters:
+//      none
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      none expected
+bool Dashboard::ShowInitialDisplay() {
+    // The colors of the game, see GameBoard::ShowInitialDisplay
+    int fgColors[] = { COLOR_WHITE, COLOR_BLACK, COLOR_BLACK, COLOR_WHITE, COLOR_WHITE, COLOR_BLACK };
+    int bgColors[] = { COLOR_RED, COLOR_GREEN, COLOR_YELLOW, COLOR_BLUE, COLOR_MAGENTA, COLOR_CYAN };
+
+    if (!_mainWindow.Display(fgColors, bgColors, sizeof(fgColors)/sizeof(fgColors[0]))) {
+        return false;
+    }
+    curs_set(0);
+    for (int i = 0; i < (int)_plots.size(); i ++) {
+        BoardSnapshot empty = BoardSnapshot();
+
+        empty.winner = -1;
+        DrawBoard(i, empty);
+        _plots[i].RefreshLater();
+    }
+    _mainWindow.Update();
+    return true;
+}
+
+//  Draw one frame: the latest snapshot of every board published since the
+//      last frame, and the status written since, in one update of the
+//      terminal.  Boards whose game did not change cost nothing
+//  Parameters:
+//      slots - the slots of the boards, one per board
+//  Returns:
+//      number of boards drawn
+//  Possible Errors:
+//      none
+int Dashboard::Update(SnapshotSlot slots[]) {
+    int drawn = 0;
+
+    for (int i = 0; i < (int)_plots.size(); i ++) {
+        if (slots[i].Take()) {
+            DrawBoard(i, slots[i].Front());
+            _plots[i].RefreshLater();
+            drawn ++;
+        }
+    }
+    _mainWindow.Update();
+    return drawn;
+}
+
+//  Write the line of status below the boards, shown with the next Update
+//  Parameters:
+//      message - text to write
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Dashboard::WriteStatus(const string& message) {
+    _status.Erase();
+    _status.Write(0, 0, message);
+    _status.RefreshLater();
+}
+
+//  Wait for a key, for at most a given time, see MainWindow::GetKey
+//  Parameters:
+//      milliseconds - longest time to wait, or negative to wait for a key
+//  Returns:
+//      the key, or ERR if none came in time
+//  Possible Errors:
+//      none
+int Dashboard::GetKey(int milliseconds) {
+    return _mainWindow.GetKey(milliseconds);
+}
+
+//  Draw a snapshot of a game into the plot of its board: the grid each
+//      player fires at, the first player's on the left, and below them the
+//      shots of each player around the number of the game.  The winner's
+//      shots stand out
+//  Parameters:
+//      board - index of the board
+//      snapshot - the state of its game
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Dashboard::DrawBoard(int board, const BoardSnapshot& snapshot) {
+    PlotWindow& plot = _plots[board];
+    chtype line[TILE_WIDTH];
+    string text;
+
+    for (int row = 0; row < COUNT_ROWS; row ++) {
+        for (int player = 0; player < 2; player ++) {
+            for (int column = 0; column < COUNT_COLUMNS; column ++) {
+                BoardMask square = (BoardMask)1 << (row*COUNT_COLUMNS + column);
+                chtype cell;
+
+                if (0 == (snapshot.shot[player] & square)) {
+                    cell = (snapshot.occupied[player] & square) != 0 ? 'o' : ' ';
+                }
+                else if (0 == (snapshot.occupied[player] & square)) {
+                    cell = '.';
+                }
+                else {
+                    cell = PlotWindow::MakeCell((snapshot.sunk[player] & square) != 0 ? '#' : '*', RED_INVERSE);
+                }
+                line[player*(COUNT_COLUMNS + 1) + column] = cell;
+            }
+        }
+        line[COUNT_COLUMNS] = ACS_VLINE;
+        plot.WriteRun(0, row, line, TILE_WIDTH);
+    }
+
+    // Status: shots, game number, shots
+    plot.Write(0, COUNT_ROWS, string(TILE_WIDTH, ' '));
+    if (snapshot.version > 0) {
+        text = "#" + to_string(snapshot.game);
+        plot.Write((TILE_WIDTH - (int)text.length())/2, COUNT_ROWS, text);
+        text = to_string(snapshot.shots[0]);
+        plot.Write(0, COUNT_ROWS, text, DEFAULT_COLOR, 0 == snapshot.winner ? A_STANDOUT : A_NORMAL);
+        text = to_string(snapshot.shots[1]);
+        plot.Write(TILE_WIDTH - (int)text.length(), COUNT_ROWS, text, DEFAULT_COLOR,
+                   1 == snapshot.winner ? A_STANDOUT : A_NORMAL);
+    }
+}
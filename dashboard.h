@@ -0,0 +1,57 @@
+// Title: Lab 6 - dashboard.h
+//
+// Purpose: Declares the Dashboard class, which shows many games being played
+//          at once, e.g. by a tournament, as a wall of small boards.
+//
+//          Each board is a tile showing the grids both players fire at side
+//          by side, with the number of the game and the shots each player
+//          has fired below them.  A ship square is an o, a miss a dot, a hit
+//          a red * and a sunk ship a red #.  The games reach the dashboard
+//          through SnapshotSlots, and each frame draws the latest snapshot
+//          of every game that changed, all in one update of the terminal.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_DASHBOARD_H
+#define BATTLESHIP_DASHBOARD_H
+
+#include <string>
+#include <vector>
+#include "battleship.h"
+#include "boardSnapshot.h"
+#include "cursesWindow.h"
+
+// Size of the plot of one board: the two grids with a line between them,
+// and a line of status below
+const int TILE_HEIGHT = COUNT_ROWS + 1;
+const int TILE_WIDTH = 2*COUNT_COLUMNS + 1;
+
+// Width of the line of status of the whole dashboard
+const int DASHBOARD_STATUS_WIDTH = 72;
+
+//  Class that shows many games at once as a wall of boards
+class Dashboard {
+public:
+    Dashboard(int boards, int columns);
+
+    bool UseTerminal(const string& type, FILE* output, FILE* input);
+    bool ShowInitialDisplay();
+    int Update(SnapshotSlot slots[]);
+    void WriteStatus(const string& message);
+    int GetKey(int milliseconds);
+
+private:
+    void DrawBoard(int board, const BoardSnapshot& snapshot);
+
+    // Main window, constructed first so it is destroyed after the rest
+    MainWindow _mainWindow;
+
+    // The rows of tiles, each tile a bordered plot
+    vector<HGroup> _rows;
+    vector<VGroup> _tiles;
+    vector<PlotWindow> _plots;
+    PlotWindow _status;
+};
+
+#endif //BATTLESHIP_DASHBOARD_H
@@ -0,0 +1,179 @@
+// Title: Lab 6 - dashboardMain.cpp
+//
+// Purpose: Play a tournament of CPU against CPU games and watch many of them
+//          at once on a dashboard, then report the statistics as the
+//          Simulator does.  The tournament plays on its own threads and
+//          never waits for the screen: each board shows the latest state of
+//          one game, drawn at most fps times a second.  Press q to stop.
+//
+//          Usage: Dashboard [-boards n] [-columns n] [-threads n] [-fps n]
+//                           [-games n] [-seed s] [-heatmap model]
+//                           [strategy [strategy]]
+//              where a strategy is "hunt", "endgame" or "density", as for
+//              the Simulator
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <string>
+#include <vector>
+#include "dashboard.h"
+#include "tournament.h"
+
+const int DEFAULT_BOARDS = 16;
+const int DEFAULT_FPS = 30;
+const long DEFAULT_GAMES = 1000000000L;
+const uint64_t DEFAULT_SEED = 1;
+
+int main(int argc, char* argv[]) {
+    int boards;
+    int columns;
+    int threads;
+    int fps;
+    long games;
+    uint64_t seed;
+    StrategyKind strategies[2] = { HUNT_TARGET, HUNT_TARGET };
+    int strategyCount;
+    SimulationStats stats;
+    Heatmap heatmap;
+    bool useHeatmap;
+    double seconds;
+
+    boards = DEFAULT_BOARDS;
+    columns = 0;
+    threads = (int)thread::hardware_concurrency();
+    fps = DEFAULT_FPS;
+    games = DEFAULT_GAMES;
+    seed = DEFAULT_SEED;
+    strategyCount = 0;
+    useHeatmap = false;
+    for (int i = 1; i < argc; i ++) {
+        string option = argv[i];
+
+        if (i + 1 < argc && "-boards" == option) {
+            boards = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && "-columns" == option) {
+            columns = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && "-threads" == option) {
+            threads = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && "-fps" == option) {
+            fps = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && "-games" == option) {
+            games = atol(argv[++i]);
+        }
+        else if (i + 1 < argc && "-seed" == option) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (i + 1 < argc && "-heatmap" == option) {
+            useHeatmap = true;
+            if (!heatmap.Load(argv[++i])) {
+                cerr << "Cannot read heatmap " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (strategyCount < 2 && ParseStrategy(option, strategies[strategyCount])) {
+            strategyCount ++;
+        }
+        else {
+            games = 0;
+            break;
+        }
+    }
+    if (1 == strategyCount) {
+        strategies[1] = strategies[0];
+    }
+    if (games <= 0 || boards <= 0 || columns < 0 || fps <= 0) {
+        cerr << "Usage: " << argv[0] << " [-boards n] [-columns n] [-threads n] [-fps n]" << endl;
+        cerr << "       " << string(strlen(argv[0]), ' ') << " [-games n] [-seed s] [-heatmap model]" << endl;
+        cerr << "       " << string(strlen(argv[0]), ' ') << " [hunt|endgame|density [hunt|endgame|density]]" << endl;
+        return 1;
+    }
+    if (0 == columns) {
+        columns = (int)ceil(sqrt((double)boards));
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+
+    vector<SnapshotSlot> slots(boards);
+    Tournament tournament(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, threads, strategies[0], strategies[1]);
+    tournament.UsePriors(useHeatmap ? &heatmap : nullptr);
+    tournament.Watch(slots.data(), boards);
+
+    auto start = chrono::steady_clock::now();
+    {
+        Dashboard dashboard(boards, columns);
+        atomic<bool> done(false);
+        chrono::steady_clock::duration frame = chrono::microseconds(1000000 / fps);
+        chrono::steady_clock::time_point next;
+        double frameMs;
+        long shown;
+
+        if (!dashboard.ShowInitialDisplay()) {
+            return 1;
+        }
+
+        // The render loop below is the only reader of the slots
+        thread player([&]() {
+            tournament.Run(games, seed, stats);
+            done.store(true);
+        });
+
+        frameMs = 0;
+        shown = 0;
+        next = chrono::steady_clock::now();
+        while (!done.load()) {
+            chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            chrono::duration<double> elapsed;
+            long published;
+            long wait;
+            char status[DASHBOARD_STATUS_WIDTH + 1];
+
+            // Sleep in the terminal until the next frame is due
+            next += frame;
+            wait = (long)chrono::duration_cast<chrono::milliseconds>(next - now).count();
+            if (wait < 0) {
+                next = now;
+                wait = 0;
+            }
+            if ('q' == dashboard.GetKey((int)wait)) {
+                tournament.Stop();
+            }
+
+            now = chrono::steady_clock::now();
+            elapsed = now - start;
+            published = 0;
+            for (const SnapshotSlot& slot : slots) {
+                published += (long)slot.Front().version;
+            }
+            snprintf(status, sizeof(status), "Games %ld  %.0f/s  Frame %.2f ms  Shown %ld of %ld states  q quits",
+                     tournament.GetGamesPlayed(), tournament.GetGamesPlayed()/elapsed.count(),
+                     frameMs, shown, published);
+            dashboard.WriteStatus(status);
+            shown += dashboard.Update(slots.data());
+            frameMs = chrono::duration<double, milli>(chrono::steady_clock::now() - now).count();
+        }
+        player.join();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        dashboard.WriteStatus("Done, press any key for the results");
+        dashboard.Update(slots.data());
+        dashboard.GetKey(-1);
+    }
+
+    cout << "Threads:        " << threads << endl;
+    stats.Report(cout, seconds);
+    return 0;
+}
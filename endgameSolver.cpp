@@ -0,0 +1,439 @@
+// Title: Lab 6 - endgameSolver.cpp
+//
+// Purpose: Implements the EndgameSolver class, which lists every layout of
+//          the opponent's ships that is consistent with the shots fired so
+//          far and picks the shot that leads to the fewest expected misses.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <algorithm>
+#include <functional>
+#include "endgameSolver.h"
+
+// Partial layouts are memoized by the squares covered, with the set of
+// ships placed packed in the bits above the board
+const int KEY_PLACED_SHIFT = 100;
+static_assert(COUNT_SQUARES <= KEY_PLACED_SHIFT && KEY_PLACED_SHIFT + SHIPS_MAX <= 128,
+              "partial layout key must fit");
+
+//  Return whether a ship could be placed somewhere given the shots: it
+//      must miss the misses, and holds one sink if all its squares are
+//      hit and none otherwise
+//  Parameters:
+//      placement - squares of the ship
+//      misses, hits, sinks - as for EndgameSolver::Solve
+//  Returns:
+//      true if the placement is consistent with the shots
+//  Possible Errors:
+//      none
+static inline bool IsLegal(BoardMask placement, BoardMask misses, BoardMask hits, BoardMask sinks) {
+    if ((placement & misses) != 0) {
+        return false;
+    }
+    return (placement & ~hits) == 0 ? Popcount(placement & sinks) == 1 : (placement & sinks) == 0;
+}
+
+//
+//  Constructor
+//  Parameters:
+//      ships - roster of ships the opponent places, only sizes are used
+//      shipCount - number of elements in ships
+EndgameSolver::EndgameSolver(const Ship ships[], int shipCount) {
+    const PlacementMasks& masks = Masks();
+
+    _shipCount = shipCount < SHIPS_MAX ? shipCount : SHIPS_MAX;
+    for (int i = 0; i < _shipCount; i ++) {
+        _sizes[i] = ships[i].size < 0 || ships[i].size > ENDGAME_LENGTH_MAX ? 0 : ships[i].size;
+    }
+    sort(_sizes, _sizes + _shipCount, greater<int>());
+    _nodes = 0;
+
+    // Every placement of each ship size that fits on the board
+    for (int size = 1; size <= ENDGAME_LENGTH_MAX; size ++) {
+        for (int start = 0; start < COUNT_SQUARES; start ++) {
+            if (masks.hStarts[size] & ((BoardMask)1 << start)) {
+                _placements[size].push_back(masks.hShip[size] << start);
+            }
+            if (size > 1 && start / COUNT_COLUMNS + size <= COUNT_ROWS) {
+                _placements[size].push_back(masks.vShip[size] << start);
+            }
+        }
+    }
+    Init();
+}
+
+//  Forget the layouts listed for the last game, ready for a new one
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void EndgameSolver::Init() {
+    _listed = false;
+    _misses = 0;
+    _hits = 0;
+    _sinks = 0;
+    _found.clear();
+}
+
+//  Choose the next shot, if few enough layouts are consistent with the
+//      shots fired so far
+//  Parameters:
+//      misses - squares fired at that missed
+//      hits - squares fired at that hit a ship
+//      sinks - squares whose shot sank a ship (a subset of hits)
+//      square - receives the square to fire at, row*COUNT_COLUMNS+column
+//  Returns:
+//      true if a shot was chosen, false if there are too many layouts
+//      to list or none at all
+//  Possible Errors:
+//      none
+bool EndgameSolver::Solve(BoardMask misses, BoardMask hits, BoardMask sinks, int& square) {
+    // More shots in the same game only rule layouts out
+    if (_listed && (misses & _misses) == _misses && (hits & _hits) == _hits && (sinks & _sinks) == _sinks) {
+        FilterLayouts(misses, hits, sinks);
+    }
+    else {
+        _listed = ListLayouts(misses, hits, sinks);
+    }
+    _misses = misses;
+    _hits = hits;
+    _sinks = sinks;
+    if (!_listed || _found.empty()) {
+        return false;
+    }
+    MergeLayouts();
+    square = _layouts.size() <= ENDGAME_EXACT_MAX ? ExactShot(hits) : LikeliestShot(hits);
+    return square >= 0;
+}
+
+//  List the layouts consistent with the shots into _found
+//  Parameters:
+//      misses, hits, sinks - as for Solve
+//  Returns:
+//      false if there are more than ENDGAME_LAYOUTS_MAX layouts or they
+//      take more than ENDGAME_NODES_MAX search nodes to list
+//  Possible Errors:
+//      none
+bool EndgameSolver::ListLayouts(BoardMask misses, BoardMask hits, BoardMask sinks) {
+    for (int i = 0; i < _shipCount; i ++) {
+        _legal[i].clear();
+        if (i > 0 && _sizes[i] == _sizes[i-1]) {
+            _legal[i] = _legal[i-1];
+            continue;
+        }
+        for (BoardMask placement : _placements[_sizes[i]]) {
+            if (IsLegal(placement, misses, hits, sinks)) {
+                _legal[i].push_back(placement);
+            }
+        }
+    }
+
+    // Only placements covering a hit are needed by square
+    for (int i = 0; i < _shipCount; i ++) {
+        for (int s = 0; s < COUNT_SQUARES; s ++) {
+            _covering[i][s].clear();
+        }
+        for (BoardMask placement : _legal[i]) {
+            BoardMask covered = placement & hits;
+
+            while (covered != 0) {
+                _covering[i][SelectBit(covered, 0)].push_back(placement);
+                covered &= covered - 1;
+            }
+        }
+    }
+
+    _hits = hits;
+    _nodes = 0;
+    _dead.clear();
+    _found.clear();
+    CoverHits(0, 0);
+    return _nodes <= ENDGAME_NODES_MAX && _found.size() <= ENDGAME_LAYOUTS_MAX;
+}
+
+//  Drop the layouts in _found that more shots have ruled out
+//  Parameters:
+//      misses, hits, sinks - as for Solve, including the earlier shots
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void EndgameSolver::FilterLayouts(BoardMask misses, BoardMask hits, BoardMask sinks) {
+    size_t kept = 0;
+
+    for (size_t i = 0; i < _found.size(); i ++) {
+        bool legal = (hits & ~_found[i].squares) == 0;
+
+        for (int ship = 0; ship < _shipCount && legal; ship ++) {
+            legal = IsLegal(_found[i].ships[ship], misses, hits, sinks);
+        }
+        if (legal) {
+            _found[kept++] = _found[i];
+        }
+    }
+    _found.resize(kept);
+}
+
+//  Merge the layouts in _found that cover the same squares into _layouts,
+//      with their number in _weights
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void EndgameSolver::MergeLayouts() {
+    _squares.clear();
+    for (const EndgameLayout& layout : _found) {
+        _squares.push_back(layout.squares);
+    }
+    sort(_squares.begin(), _squares.end());
+    _layouts.clear();
+    _weights.clear();
+    for (size_t i = 0; i < _squares.size(); i ++) {
+        if (i > 0 && _squares[i] == _squares[i-1]) {
+            _weights.back() ++;
+        }
+        else {
+            _layouts.push_back(_squares[i]);
+            _weights.push_back(1);
+        }
+    }
+}
+
+//  Place ships to cover the hits, the lowest uncovered hit first, then
+//      place the rest.  Of ships of equal size only the first not yet
+//      placed is tried, so each layout is found once.  Partial layouts
+//      found to have no completion are remembered and not searched again
+//  Parameters:
+//      placed - bit i set if ship i has been placed
+//      occupied - squares covered by the ships placed so far
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none, the search stops early once it is over its limits
+void EndgameSolver::CoverHits(int placed, BoardMask occupied) {
+    BoardMask uncovered = _hits & ~occupied;
+    BoardMask key;
+    int square;
+    size_t layoutsBefore;
+
+    if (++_nodes > ENDGAME_NODES_MAX || _found.size() > ENDGAME_LAYOUTS_MAX) {
+        return;
+    }
+    if (0 == uncovered) {
+        PlaceRest(0, placed, occupied, 0);
+        return;
+    }
+    key = occupied | (BoardMask)placed << KEY_PLACED_SHIFT;
+    if (_dead.count(key) > 0) {
+        return;
+    }
+
+    square = SelectBit(uncovered, 0);
+    layoutsBefore = _found.size();
+    for (int ship = 0; ship < _shipCount; ship ++) {
+        if ((placed & (1 << ship)) != 0
+            || (ship > 0 && _sizes[ship] == _sizes[ship-1] && (placed & (1 << (ship-1))) == 0)) {
+            continue;
+        }
+        for (BoardMask placement : _covering[ship][square]) {
+            if ((placement & occupied) == 0) {
+                _layout.ships[ship] = placement;
+                CoverHits(placed | (1 << ship), occupied | placement);
+            }
+        }
+    }
+    if (_found.size() == layoutsBefore && _nodes <= ENDGAME_NODES_MAX) {
+        _dead.insert(key);
+    }
+}
+
+//  Place the ships left once every hit is covered, recording each
+//      layout.  They cannot touch a hit, so none of them is sunk.  Ships
+//      of equal size are placed in increasing placement order
+//  Parameters:
+//      ship - index of the next ship to consider
+//      placed - bit i set if ship i has been placed
+//      occupied - squares covered by the ships placed so far
+//      first - first placement to try for the next ship
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none, the search stops early once it is over its limits
+void EndgameSolver::PlaceRest(int ship, int placed, BoardMask occupied, int first) {
+    while (ship < _shipCount && (placed & (1 << ship)) != 0) {
+        ship ++;
+    }
+    if (ship == _shipCount) {
+        _layout.squares = occupied;
+        _found.push_back(_layout);
+        return;
+    }
+    if (++_nodes > ENDGAME_NODES_MAX || _found.size() > ENDGAME_LAYOUTS_MAX) {
+        return;
+    }
+    for (size_t i = first; i < _legal[ship].size(); i ++) {
+        bool sameSize = ship + 1 < _shipCount && _sizes[ship + 1] == _sizes[ship];
+
+        if ((_legal[ship][i] & occupied) == 0) {
+            _layout.ships[ship] = _legal[ship][i];
+            PlaceRest(ship + 1, placed, occupied | _legal[ship][i], sameSize ? (int)i + 1 : 0);
+        }
+    }
+}
+
+//  Choose the shot that minimizes the expected number of misses still to
+//      come, searching every sequence of shots.  Squares covered in every
+//      layout are sure hits and are fired at first
+//  Parameters:
+//      hits - squares fired at that hit a ship
+//  Returns:
+//      the square to fire at
+//  Possible Errors:
+//      none
+int EndgameSolver::ExactShot(BoardMask hits) {
+    uint32_t all = ((uint32_t)1 << _layouts.size()) - 1;
+    BoardMask common = ~(BoardMask)0;
+    double misses;
+
+    for (size_t i = 0; i < _layouts.size(); i ++) {
+        common &= _layouts[i];
+    }
+    if ((common & ~hits) != 0) {
+        return SelectBit(common & ~hits, 0);
+    }
+
+    // Which layouts cover each square some but not all of them cover
+    _candidates.clear();
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        _cover[s] = 0;
+        for (size_t i = 0; i < _layouts.size(); i ++) {
+            if (_layouts[i] & ((BoardMask)1 << s)) {
+                _cover[s] |= (uint32_t)1 << i;
+            }
+        }
+        if (_cover[s] != 0 && _cover[s] != all) {
+            _candidates.push_back(s);
+        }
+    }
+    _memo.clear();
+    return BestShot(all, misses);
+}
+
+//  Find the best shot when the layout is one of a subset of the layouts.
+//      Squares that split the subset the same way lead to the same
+//      positions, so only the first of them is searched
+//  Parameters:
+//      subset - bit i set if _layouts[i] is still possible
+//      misses - receives the expected number of misses still to come
+//  Returns:
+//      the square to fire at, -1 if the layout is known
+//  Possible Errors:
+//      none
+int EndgameSolver::BestShot(uint32_t subset, double& misses) {
+    uint32_t splits[COUNT_SQUARES];
+    int splitCount = 0;
+    long total = Weight(subset);
+    int best = -1;
+
+    misses = 0;
+    for (int square : _candidates) {
+        uint32_t hitSubset = _cover[square] & subset;
+        bool seen = false;
+        double expected;
+
+        if (0 == hitSubset || subset == hitSubset) {
+            continue;
+        }
+        for (int i = 0; i < splitCount && !seen; i ++) {
+            seen = splits[i] == hitSubset;
+        }
+        if (seen) {
+            continue;
+        }
+        splits[splitCount++] = hitSubset;
+        expected = (double)Weight(hitSubset) / total * ExpectedMisses(hitSubset)
+                   + (double)Weight(subset & ~hitSubset) / total * (1 + ExpectedMisses(subset & ~hitSubset));
+        if (best < 0 || expected < misses) {
+            best = square;
+            misses = expected;
+        }
+    }
+    return best;
+}
+
+//  Return the expected number of misses before the ships are found when
+//      the layout is one of a subset of the layouts and every shot is
+//      chosen as well as possible
+//  Parameters:
+//      subset - bit i set if _layouts[i] is still possible
+//  Returns:
+//      expected misses
+//  Possible Errors:
+//      none
+double EndgameSolver::ExpectedMisses(uint32_t subset) {
+    double misses;
+
+    if ((subset & (subset - 1)) == 0) {
+        return 0;
+    }
+    auto memo = _memo.find(subset);
+    if (memo != _memo.end()) {
+        return memo->second;
+    }
+    BestShot(subset, misses);
+    _memo[subset] = misses;
+    return misses;
+}
+
+//  Return the total weight of a subset of the layouts
+//  Parameters:
+//      subset - bit i set to include _layouts[i]
+//  Returns:
+//      sum of their weights
+//  Possible Errors:
+//      none
+long EndgameSolver::Weight(uint32_t subset) const {
+    long total = 0;
+
+    while (subset != 0) {
+        total += _weights[__builtin_ctz(subset)];
+        subset &= subset - 1;
+    }
+    return total;
+}
+
+//  Choose the square not yet hit that the most layouts cover
+//  Parameters:
+//      hits - squares fired at that hit a ship
+//  Returns:
+//      the square to fire at
+//  Possible Errors:
+//      none
+int EndgameSolver::LikeliestShot(BoardMask hits) const {
+    long weight[COUNT_SQUARES] = { 0 };
+    int best = -1;
+
+    for (size_t i = 0; i < _layouts.size(); i ++) {
+        BoardMask squares = _layouts[i] & ~hits;
+
+        for (int half = 0; half < 2; half ++) {
+            uint64_t word = (uint64_t)(squares >> (64*half));
+
+            while (word != 0) {
+                weight[64*half + __builtin_ctzll(word)] += _weights[i];
+                word &= word - 1;
+            }
+        }
+    }
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        if (weight[s] > 0 && (best < 0 || weight[s] > weight[best])) {
+            best = s;
+        }
+    }
+    return best;
+}
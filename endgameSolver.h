@@ -0,0 +1,106 @@
+// Title: Lab 6 - endgameSolver.h
+//
+// Purpose: Declares the EndgameSolver class, which lists every layout of
+//          the opponent's ships that is consistent with the shots fired so
+//          far and picks the shot that leads to the fewest expected misses.
+//          It gives up when there are too many layouts, so the caller
+//          keeps its own strategy until late in the game.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_ENDGAMESOLVER_H
+#define BATTLESHIP_ENDGAMESOLVER_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "boardMask.h"
+
+// Longest ship that fits on the board
+const int ENDGAME_LENGTH_MAX = COUNT_ROWS > COUNT_COLUMNS ? COUNT_ROWS : COUNT_COLUMNS;
+
+// The solver takes over once there are at most this many layouts
+const int ENDGAME_LAYOUTS_MAX = 1000;
+
+// Search nodes to visit while listing layouts before giving up
+const long ENDGAME_NODES_MAX = 5000;
+
+// Distinct sets of ship squares for which the shot is chosen by searching
+// every sequence of shots, with more the most likely hit is fired at
+const int ENDGAME_EXACT_MAX = 10;
+
+//  Hash of a BoardMask for the memo tables
+struct BoardMaskHash {
+    size_t operator()(BoardMask mask) const {
+        uint64_t x = (uint64_t)mask ^ ((uint64_t)(mask >> 64) * 0x9E3779B97F4A7C15ULL);
+
+        return (size_t)(x ^ (x >> 29));
+    }
+};
+
+//  A layout found by the solver: the squares of each ship and of them all
+struct EndgameLayout {
+    BoardMask ships[SHIPS_MAX];
+    BoardMask squares;
+};
+
+//  Class finding the best shot late in a game
+//      A layout places every ship of the roster so that no ship covers a
+//      miss, every hit is covered, and the ships whose squares have all
+//      been hit are exactly those sunk: each holds one of the squares
+//      where a ship was reported sunk.  (Which of its squares was hit
+//      last is not checked.)  Layouts that cover the same squares cannot
+//      be told apart by shooting, so they are merged, weighted by how many
+//      there are.  Misses are the only wasted shots, so the best shot is
+//      the one that minimizes the expected number of misses still to come.
+//      Once the layouts have been listed, later calls in the same game
+//      only drop the layouts the new shots rule out.
+class EndgameSolver {
+public:
+    EndgameSolver(const Ship ships[] = CLASSIC_SHIPS, int shipCount = CLASSIC_SHIP_COUNT);
+
+    void Init();
+    bool Solve(BoardMask misses, BoardMask hits, BoardMask sinks, int& square);
+
+private:
+    bool ListLayouts(BoardMask misses, BoardMask hits, BoardMask sinks);
+    void FilterLayouts(BoardMask misses, BoardMask hits, BoardMask sinks);
+    void MergeLayouts();
+    void CoverHits(int placed, BoardMask occupied);
+    void PlaceRest(int ship, int placed, BoardMask occupied, int first);
+    int ExactShot(BoardMask hits);
+    int BestShot(uint32_t subset, double& misses);
+    double ExpectedMisses(uint32_t subset);
+    long Weight(uint32_t subset) const;
+    int LikeliestShot(BoardMask hits) const;
+
+    // Ships to find, longest first
+    int _sizes[SHIPS_MAX];
+    int _shipCount;
+    vector<BoardMask> _placements[ENDGAME_LENGTH_MAX+1];  // every placement of each size
+
+    // The shots the layouts were listed for, if they could be
+    bool _listed;
+    BoardMask _misses;
+    BoardMask _hits;
+    BoardMask _sinks;
+    vector<EndgameLayout> _found;
+
+    // State of the search for layouts
+    vector<BoardMask> _legal[SHIPS_MAX];    // placements of each ship consistent with the shots
+    vector<BoardMask> _covering[SHIPS_MAX][COUNT_SQUARES];  // the same, by the squares they cover
+    EndgameLayout _layout;                  // the partial layout being searched
+    long _nodes;
+    unordered_set<BoardMask, BoardMaskHash> _dead;  // partial layouts with no completion
+
+    // The merged layouts, and the exact search over subsets of them
+    vector<BoardMask> _squares;
+    vector<BoardMask> _layouts;
+    vector<long> _weights;
+    uint32_t _cover[COUNT_SQUARES];         // per square, bit i set if _layouts[i] covers it
+    vector<int> _candidates;                // squares covered by some but not all layouts
+    unordered_map<uint32_t, double> _memo;  // subset of the layouts -> expected misses
+};
+
+#endif //BATTLESHIP_ENDGAMESOLVER_H
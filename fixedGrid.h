@@ -0,0 +1,425 @@
+// Title: Lab 6 - fixedGrid.h
+//
+// Purpose: Declares and implements FixedGrid, a battleship grid whose
+//          size and ship limit are template parameters.  It has the same
+//          API as Grid, but every board fits in one BoardMask and the
+//          placement masks are computed at compile time, so shots, sunk
+//          checks and placement are straight-line mask operations with
+//          no loops over words or squares.  ClassicGrid is the 10x10,
+//          five ship instantiation the simulator uses.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_FIXEDGRID_H
+#define BATTLESHIP_FIXEDGRID_H
+
+#include <cstring>
+#include <fstream>
+#include "grid.h"
+#include "boardMask.h"
+
+using namespace std;
+
+//  Class representing a grid of fixed size, see Grid for the meaning of
+//      each method
+//      ships - the ships placed on the grid
+//      shipMasks - squares of each ship, the ship is sunk when they are
+//          all shot
+//      shipsDeployed -- the number of ships that are on the grid (<= MaxShips)
+//      occupied, shot, sunk -- squares covered by a ship, squares a shot has
+//          landed on, and squares belonging to a sunk ship; the game is won
+//          when every occupied square is shot
+//      shipIndex -- per square index into ships, or NO_SHIP
+template <int Rows, int Columns, int MaxShips>
+class FixedGrid {
+    static_assert(Rows > 0 && Columns > 0 && Rows*Columns <= 128, "board must fit in a BoardMask");
+    static_assert(MaxShips > 0 && MaxShips <= SHIPS_LIMIT, "ship indices must fit in a byte");
+
+public:
+    FixedGrid();
+
+    int GetRows() const;
+    int GetColumns() const;
+    int GetShipsMax() const;
+
+    void Init();
+    bool LoadShips(ifstream& file);
+    bool SaveShips(ofstream& file);
+
+    void RandomlyPlaceShips(const Ship ships[], int shipCount, Rng& rng);
+
+    bool AddShip(const string& name, int size, bool isVertical, int startRow, int startColumn);
+    int GetShipsSunk() const;
+    int GetShipsDeployed() const;
+    void GetShip(int i, Ship& ship) const;
+    int FindShip(int row, int column) const;
+
+    bool FireShot(int row, int column, Outcome& outcome);
+    bool FireShot(int row, int column, Outcome& outcome, ShotChanges& changes);
+
+    SquareStatus GetSquareStatus(int row, int column) const;
+
+    BoardMask GetOccupied() const;
+    BoardMask GetShot() const;
+    BoardMask GetSunk() const;
+
+private:
+    typedef FixedMasks<Rows, Columns> Masks;
+    static constexpr Masks MASKS = Masks();
+
+    void PlaceShip(const string& name, int size, bool isVertical, int startRow, int startColumn);
+    static bool OnGrid(int row, int column);
+
+    Ship _ships[MaxShips];
+    BoardMask _shipMasks[MaxShips];
+    int _shipsDeployed;
+    BoardMask _occupied;
+    BoardMask _shot;
+    BoardMask _sunk;
+    unsigned char _shipIndex[Rows*Columns];
+};
+
+// The classic board
+typedef FixedGrid<COUNT_ROWS, COUNT_COLUMNS, SHIPS_MAX> ClassicGrid;
+
+template <int Rows, int Columns, int MaxShips>
+constexpr FixedMasks<Rows, Columns> FixedGrid<Rows, Columns, MaxShips>::MASKS;
+
+//
+//  Constructor
+template <int Rows, int Columns, int MaxShips>
+FixedGrid<Rows, Columns, MaxShips>::FixedGrid() {
+    Init();
+}
+
+//  Return the number of rows
+template <int Rows, int Columns, int MaxShips>
+int FixedGrid<Rows, Columns, MaxShips>::GetRows() const {
+    return Rows;
+}
+
+//  Return the number of columns
+template <int Rows, int Columns, int MaxShips>
+int FixedGrid<Rows, Columns, MaxShips>::GetColumns() const {
+    return Columns;
+}
+
+//  Return the most ships the grid holds
+template <int Rows, int Columns, int MaxShips>
+int FixedGrid<Rows, Columns, MaxShips>::GetShipsMax() const {
+    return MaxShips;
+}
+
+//  Reset the grid to be empty
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+template <int Rows, int Columns, int MaxShips>
+void FixedGrid<Rows, Columns, MaxShips>::Init() {
+    _shipsDeployed = 0;
+    _occupied = 0;
+    _shot = 0;
+    _sunk = 0;
+    memset(_shipIndex, NO_SHIP, sizeof(_shipIndex));
+}
+
+//  Test whether a square is on the grid
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      true if it is on the grid
+//  Possible Errors:
+//      none
+template <int Rows, int Columns, int MaxShips>
+bool FixedGrid<Rows, Columns, MaxShips>::OnGrid(int row, int column) {
+    return (unsigned)row < (unsigned)Rows && (unsigned)column < (unsigned)Columns;
+}
+
+//  Read the ship configuration from a file, in the format read by
+//      Grid::LoadShips
+//  Parameters:
+//      file - input file stream
+//  Returns:
+//      true if all ships were read and placed
+//  Possible Errors:
+//      badly formatted file, too many ships, ships off grid or overlapping
+template <int Rows, int Columns, int MaxShips>
+bool FixedGrid<Rows, Columns, MaxShips>::LoadShips(ifstream& file) {
+    Init();
+    return ReadShips(file, *this);
+}
+
+//  Write the ship configuration to a file in the format read by LoadShips
+//  Parameters:
+//      file - output file stream
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      write failure
+template <int Rows, int Columns, int MaxShips>
+bool FixedGrid<Rows, Columns, MaxShips>::SaveShips(ofstream& file) {
+    return WriteShips(file, *this);
+}
+
+//  Place the ships at random positions on an empty grid, laid out by
+//      RandomLayout as Grid::RandomlyPlaceShips does, so the same random
+//      numbers give the same layout.  The shifts are by compile-time amounts
+//  Parameters:
+//      ships - ships to place, only name and size are used
+//      shipCount - number of elements in ships
+//      rng - random number generator to use
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      if a ship finds no room left the board is started over, after
+//      PLACEMENT_RESTARTS_MAX tries the ships placed so far are kept
+template <int Rows, int Columns, int MaxShips>
+void FixedGrid<Rows, Columns, MaxShips>::RandomlyPlaceShips(const Ship ships[], int shipCount, Rng& rng) {
+    Placement placements[MaxShips];
+    int placed;
+
+    placed = RandomLayout(MASKS, ships, shipCount, MaxShips, rng, placements);
+    Init();
+    for (int i = 0; i < placed; i ++) {
+        const Ship& ship = ships[placements[i].ship];
+        int bit = placements[i].bit;
+
+        PlaceShip(ship.name, ship.size, placements[i].isVertical, bit / Columns, bit % Columns);
+    }
+}
+
+//  Add a ship to the grid
+//  Parameters:
+//      name - name of the ship
+//      size - number of squares it occupies
+//      isVertical - orientation
+//      startRow - row of uppermost/leftmost square
+//      startColumn - column of uppermost/leftmost square
+//  Returns:
+//      true if the ship was added
+//  Possible Errors:
+//      too many ships, ship off grid, ship overlapping another
+template <int Rows, int Columns, int MaxShips>
+bool FixedGrid<Rows, Columns, MaxShips>::AddShip(const string& name, int size, bool isVertical,
+                                                 int startRow, int startColumn) {
+    BoardMask ship;
+
+    if (_shipsDeployed >= MaxShips || size <= 0 || !OnGrid(startRow, startColumn)) {
+        return false;
+    }
+    if (isVertical ? startRow + size > Rows : startColumn + size > Columns) {
+        return false;
+    }
+    ship = (isVertical ? MASKS.vShip[size] : MASKS.hShip[size]) << (startRow*Columns + startColumn);
+    if ((ship & _occupied) != 0) {
+        return false;
+    }
+    PlaceShip(name, size, isVertical, startRow, startColumn);
+    return true;
+}
+
+//  Put a ship on the grid without any checks, the caller has made sure
+//      it is on the grid and does not overlap another ship
+//  Parameters:
+//      name - name of the ship
+//      size - number of squares it occupies
+//      isVertical - orientation
+//      startRow - row of uppermost/leftmost square
+//      startColumn - column of uppermost/leftmost square
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+template <int Rows, int Columns, int MaxShips>
+void FixedGrid<Rows, Columns, MaxShips>::PlaceShip(const string& name, int size, bool isVertical,
+                                                   int startRow, int startColumn) {
+    int step = isVertical ? Columns : 1;
+    int bit = startRow*Columns + startColumn;
+    Ship& ship = _ships[_shipsDeployed];
+
+    _shipMasks[_shipsDeployed] = (isVertical ? MASKS.vShip[size] : MASKS.hShip[size]) << bit;
+    _occupied |= _shipMasks[_shipsDeployed];
+    for (int i = 0; i < size; i ++, bit += step) {
+        _shipIndex[bit] = (unsigned char)_shipsDeployed;
+    }
+    ship.name = name;
+    ship.size = size;
+    ship.isVertical = isVertical;
+    ship.startRow = startRow;
+    ship.startColumn = startColumn;
+    ship.hits = 0;
+    _shipsDeployed ++;
+}
+
+//  Return the number of ships that have been sunk
+template <int Rows, int Columns, int MaxShips>
+int FixedGrid<Rows, Columns, MaxShips>::GetShipsSunk() const {
+    int sunk = 0;
+
+    for (int i = 0; i < _shipsDeployed; i ++) {
+        sunk += (_shipMasks[i] & ~_sunk) == 0;
+    }
+    return sunk;
+}
+
+//  Return the number of ships on the grid
+template <int Rows, int Columns, int MaxShips>
+int FixedGrid<Rows, Columns, MaxShips>::GetShipsDeployed() const {
+    return _shipsDeployed;
+}
+
+//  Return the squares covered by ships, bit row*Columns + column
+template <int Rows, int Columns, int MaxShips>
+BoardMask FixedGrid<Rows, Columns, MaxShips>::GetOccupied() const {
+    return _occupied;
+}
+
+//  Return the squares shot at
+template <int Rows, int Columns, int MaxShips>
+BoardMask FixedGrid<Rows, Columns, MaxShips>::GetShot() const {
+    return _shot;
+}
+
+//  Return the squares of ships that have been sunk
+template <int Rows, int Columns, int MaxShips>
+BoardMask FixedGrid<Rows, Columns, MaxShips>::GetSunk() const {
+    return _sunk;
+}
+
+//  Retrieve a ship
+//  Parameters:
+//      i - index of the ship (0 <= i < GetShipsDeployed())
+//      ship - receives a copy of the ship
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+template <int Rows, int Columns, int MaxShips>
+void FixedGrid<Rows, Columns, MaxShips>::GetShip(int i, Ship& ship) const {
+    ship = _ships[i];
+    ship.hits = Popcount(_shipMasks[i] & _shot);
+}
+
+//  Find the ship occupying a square
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      index of the ship, or -1 if there is no ship there
+//  Possible Errors:
+//      none
+template <int Rows, int Columns, int MaxShips>
+int FixedGrid<Rows, Columns, MaxShips>::FindShip(int row, int column) const {
+    unsigned char index;
+
+    if (!OnGrid(row, column)) {
+        return -1;
+    }
+    index = _shipIndex[row*Columns + column];
+    return index == NO_SHIP ? -1 : index;
+}
+
+//  Fire a shot at a square.  A hit ship is sunk when none of its squares
+//      is left unshot and the game is won when no occupied square is, each
+//      a single mask test
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - receives the outcome of the shot
+//  Returns:
+//      true if the shot was on the grid
+//  Possible Errors:
+//      row or column out of range
+template <int Rows, int Columns, int MaxShips>
+bool FixedGrid<Rows, Columns, MaxShips>::FireShot(int row, int column, Outcome& outcome) {
+    BoardMask square;
+    int index;
+
+    if (!OnGrid(row, column)) {
+        return false;
+    }
+    square = (BoardMask)1 << (row*Columns + column);
+    if ((_shot & square) != 0) {
+        outcome = SHOT_HERE_BEFORE;
+        return true;
+    }
+    _shot |= square;
+
+    if ((_occupied & square) == 0) {
+        outcome = SHOT_MISSED;
+        return true;
+    }
+
+    index = _shipIndex[row*Columns + column];
+    if ((_shipMasks[index] & ~_shot) != 0) {
+        outcome = SHIP_HIT;
+        return true;
+    }
+    _sunk |= _shipMasks[index];
+    outcome = (_occupied & ~_shot) == 0 ? GAME_WON : SHIP_SUNK;
+    return true;
+}
+
+//  Fire a shot at a square, also reporting which squares changed status
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - receives the outcome of the shot
+//      changes - receives the squares whose status changed
+//  Returns:
+//      true if the shot was on the grid
+//  Possible Errors:
+//      row or column out of range
+template <int Rows, int Columns, int MaxShips>
+bool FixedGrid<Rows, Columns, MaxShips>::FireShot(int row, int column, Outcome& outcome, ShotChanges& changes) {
+    BoardMask squares;
+
+    changes.count = 0;
+    if (!FireShot(row, column, outcome)) {
+        return false;
+    }
+    if (SHOT_HERE_BEFORE == outcome) {
+        return true;
+    }
+    squares = (BoardMask)1 << (row*Columns + column);
+    if (SHIP_SUNK == outcome || GAME_WON == outcome) {
+        squares = _shipMasks[_shipIndex[row*Columns + column]];
+    }
+    while (squares != 0) {
+        changes.squares[changes.count++] = SelectBit(squares, 0);
+        squares &= squares - 1;
+    }
+    return true;
+}
+
+//  Return the status of a square
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      WATER, SHIP, MISS, HIT or SUNK
+//  Possible Errors:
+//      none, out of range squares are reported as WATER
+template <int Rows, int Columns, int MaxShips>
+SquareStatus FixedGrid<Rows, Columns, MaxShips>::GetSquareStatus(int row, int column) const {
+    BoardMask square;
+
+    if (!OnGrid(row, column)) {
+        return WATER;
+    }
+    square = (BoardMask)1 << (row*Columns + column);
+    if ((_occupied & square) != 0) {
+        if ((_shot & square) == 0) {
+            return SHIP;
+        }
+        return (_sunk & square) != 0 ? SUNK : HIT;
+    }
+    return (_shot & square) != 0 ? MISS : WATER;
+}
+
+#endif //BATTLESHIP_FIXEDGRID_H
@@ -10,7 +10,7 @@
 #include <sstream>
 #include <fstream>
 #include <assert.h>
-#include "gameboard.h"
+#include "gameBoard.h"
 
 // Titles
 const string BATTLESHIP = "BATTLESHIP";
@@ -110,4 +110,68 @@ string GameBoard::GetLine() {
     return _commandWindow.GetLine();
 }
 
-// Methods for you to add: LoadShips, RandomlyPlaceShips, and FireShots
+//  Load the ship layout of a grid from a file
+//  Parameters:
+//      forUser - true for the user's grid, false for the CPU's
+//      fileName - name of the file
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be opened, badly formed layout
+bool GameBoard::LoadShipsFromFile(bool forUser, const string& fileName) {
+    ifstream file(fileName);
+
+    if (file.fail()) {
+        return false;
+    }
+    return (forUser ? _user : _cpu).LoadShips(file);
+}
+
+//  Place the ships of a grid randomly
+//  Parameters:
+//      forUser - true for the user's grid, false for the CPU's
+//      rng - random number generator to use
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void GameBoard::RandomlyPlaceShips(bool forUser, Rng& rng) {
+    (forUser ? _user : _cpu).RandomlyPlaceShips(rng);
+}
+
+//  Fire a shot at a grid and display it
+//  Parameters:
+//      forUser - true to fire at the user's grid, false at the CPU's
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - receives the outcome of the shot
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      square is off the grid
+bool GameBoard::FireShot(bool forUser, int row, int column, Outcome& outcome) {
+    return (forUser ? _user : _cpu).FireShot(row, column, outcome);
+}
+
+//  Return the game state of a grid
+//  Parameters:
+//      forUser - true for the user's grid, false for the CPU's
+//  Returns:
+//      reference to the grid
+//  Possible Errors:
+//      none
+const Grid& GameBoard::GetGrid(bool forUser) const {
+    return (forUser ? _user : _cpu).GetGrid();
+}
+
+//  Replace the game state of a grid, redrawing it if it is displayed
+//  Parameters:
+//      forUser - true for the user's grid, false for the CPU's
+//      grid - the new state
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      grid of a different size
+bool GameBoard::SetGrid(bool forUser, const Grid& grid) {
+    return (forUser ? _user : _cpu).SetGrid(grid);
+}
@@ -24,7 +24,7 @@ public:
 
     // Ship placement
     bool LoadShipsFromFile(bool forUser, const string& fileName);
-    void RandomlyPlaceShips(bool forUser);
+    void RandomlyPlaceShips(bool forUser, Rng& rng);
 
     // Bring up initial display
     bool ShowInitialDisplay();
@@ -32,6 +32,10 @@ public:
     // Fire a shot
     bool FireShot(bool forUser, int row, int column, Outcome& outcome);
 
+    // Game state, for recording and replaying games
+    const Grid& GetGrid(bool forUser) const;
+    bool SetGrid(bool forUser, const Grid& grid);
+
     // Keyboard interface
     void WritePrompt(const string& message, int color=DEFAULT_COLOR, int attrib=A_STANDOUT);
     void WriteResponse(const string& message, int color=DEFAULT_COLOR, int attrib=A_DIM);
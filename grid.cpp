@@ -0,0 +1,532 @@
+// Title: Lab 6 - grid.cpp
+//
+// Purpose: Implements the functions that manipulate a battleship grid.
+//          The state of the squares is kept in bitboards so that shots,
+//          square lookups and ship lookups are constant time.  The grid
+//          size is set at construction and all storage is flat.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <cstring>
+#include <string>
+#include "grid.h"
+#include "boardMask.h"
+
+// The ships of the classic game
+const Ship CLASSIC_SHIPS[] = {
+    { "Carrier", 5, false, 0, 0, 0 },
+    { "Battleship", 4, false, 0, 0, 0 },
+    { "Destroyer", 3, false, 0, 0, 0 },
+    { "Submarine", 3, false, 0, 0, 0 },
+    { "PatrolBoat", 2, false, 0, 0, 0 }
+};
+const int CLASSIC_SHIP_COUNT = sizeof(CLASSIC_SHIPS)/sizeof(CLASSIC_SHIPS[0]);
+
+// The bitboards kept back to back in Grid::_bits
+enum BitBoard { OCCUPIED_BOARD, SHOT_BOARD, BIT_BOARDS };
+
+//  Test whether a square is set in a bitboard
+//  Parameters:
+//      board - bitboard
+//      bit - bit number of the square
+//  Returns:
+//      true if set
+//  Possible Errors:
+//      none
+static inline bool TestBit(const uint64_t board[], int bit) {
+    return (board[bit >> 6] >> (bit & 63)) & 1;
+}
+
+//  Set a square in a bitboard
+//  Parameters:
+//      board - bitboard
+//      bit - bit number of the square
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+static inline void SetBit(uint64_t board[], int bit) {
+    board[bit >> 6] |= (uint64_t)1 << (bit & 63);
+}
+
+//
+//  Constructor
+//      The classic 10x10 grid with up to SHIPS_MAX ships
+Grid::Grid() : Grid(COUNT_ROWS, COUNT_COLUMNS, SHIPS_MAX) {
+}
+
+//
+//  Constructor
+//      Sizes outside 1..BOARD_SIDE_MAX and ship counts outside
+//      0..SHIPS_LIMIT are clamped
+Grid::Grid(int rows, int columns, int shipsMax) {
+    _rows = rows < 1 ? 1 : rows > BOARD_SIDE_MAX ? BOARD_SIDE_MAX : rows;
+    _columns = columns < 1 ? 1 : columns > BOARD_SIDE_MAX ? BOARD_SIDE_MAX : columns;
+    _shipsMax = shipsMax < 0 ? 0 : shipsMax > SHIPS_LIMIT ? SHIPS_LIMIT : shipsMax;
+    _words = (_rows*_columns + 63)/64;
+    _ships.resize(_shipsMax);
+    _remaining.resize(_shipsMax);
+    _bits.resize(BIT_BOARDS*_words);
+    _shipIndex.resize(_rows*_columns);
+    Init();
+}
+
+//  Return the number of rows
+int Grid::GetRows() const {
+    return _rows;
+}
+
+//  Return the number of columns
+int Grid::GetColumns() const {
+    return _columns;
+}
+
+//  Return the most ships the grid holds
+int Grid::GetShipsMax() const {
+    return _shipsMax;
+}
+
+//  Reset the grid to be empty
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Grid::Init() {
+    _shipsDeployed = 0;
+    memset(_afloat, 0, sizeof(_afloat));
+    memset(_bits.data(), 0, _bits.size()*sizeof(uint64_t));
+    memset(_shipIndex.data(), NO_SHIP, _shipIndex.size());
+}
+
+//  Read the ship configuration from a file, in the format described at
+//      ReadShips
+//  Parameters:
+//      file - input file stream
+//  Returns:
+//      true if all ships were read and placed
+//  Possible Errors:
+//      badly formatted file, too many ships, ships off grid or overlapping
+bool Grid::LoadShips(ifstream& file) {
+    Init();
+    return ReadShips(file, *this);
+}
+
+//  Write the ship configuration to a file in the format read by LoadShips
+//  Parameters:
+//      file - output file stream
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      write failure
+bool Grid::SaveShips(ofstream& file) {
+    return WriteShips(file, *this);
+}
+
+//  Place the ships at random positions on an empty grid.  Each ship first
+//      makes a single guess among all its placements and keeps it if it is
+//      free, which is almost always the case on a sparse board.  Otherwise
+//      one of the legal placements is picked uniformly, so the result is
+//      uniform over the legal placements either way and there is no retry
+//      loop.  The classic board finds the legal starts with whole-board
+//      masks; other sizes scan runs of free squares
+//  Parameters:
+//      ships - ships to place, only name and size are used
+//      shipCount - number of elements in ships
+//      rng - random number generator to use
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      if a ship finds no room left the board is started over, after
+//      PLACEMENT_RESTARTS_MAX tries the ships placed so far are kept
+void Grid::RandomlyPlaceShips(const Ship ships[], int shipCount, Rng& rng) {
+    if (COUNT_ROWS == _rows && COUNT_COLUMNS == _columns) {
+        PlaceShipsClassic(ships, shipCount, rng);
+    }
+    else {
+        PlaceShipsAnySize(ships, shipCount, rng);
+    }
+}
+
+//  Randomly place ships on the classic board, laid out by RandomLayout
+//      with whole-board masks.  Nothing is allocated
+//  Parameters:
+//      ships - ships to place, only name and size are used
+//      shipCount - number of elements in ships
+//      rng - random number generator to use
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      see RandomlyPlaceShips
+void Grid::PlaceShipsClassic(const Ship ships[], int shipCount, Rng& rng) {
+    Placement placements[SHIPS_LIMIT];
+    int placed;
+
+    placed = RandomLayout(Masks(), ships, shipCount, _shipsMax, rng, placements);
+    Init();
+    for (int i = 0; i < placed; i ++) {
+        const Ship& ship = ships[placements[i].ship];
+        int bit = placements[i].bit;
+
+        PlaceShip(ship.name, ship.size, placements[i].isVertical, bit / COUNT_COLUMNS, bit % COUNT_COLUMNS);
+    }
+}
+
+//  Randomly place ships on a board of any size.  When the guess is taken,
+//      the legal starts are counted by scanning each row and each column
+//      for runs of free squares, and the picked one is found by a second scan
+//  Parameters:
+//      ships - ships to place, only name and size are used
+//      shipCount - number of elements in ships
+//      rng - random number generator to use
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      see RandomlyPlaceShips
+void Grid::PlaceShipsAnySize(const Ship ships[], int shipCount, Rng& rng) {
+    int restarts;
+
+    Init();
+    restarts = 0;
+    for (int i = 0; i < shipCount && _shipsDeployed < _shipsMax; i ++) {
+        int size = ships[i].size;
+        int hPlacements;
+        int vPlacements;
+        int hCount;
+        int vCount;
+        int pick;
+        int bit;
+        bool isVertical;
+
+        hPlacements = size <= _columns ? _rows*(_columns - size + 1) : 0;
+        vPlacements = size <= _rows ? (_rows - size + 1)*_columns : 0;
+        if (size <= 0 || 0 == hPlacements + vPlacements) {
+            continue;
+        }
+
+        // Guess among all placements, free or not
+        pick = rng.Below(hPlacements + vPlacements);
+        isVertical = pick >= hPlacements;
+        if (isVertical) {
+            bit = pick - hPlacements;
+        }
+        else {
+            bit = pick / (_columns - size + 1) * _columns + pick % (_columns - size + 1);
+        }
+
+        if (!IsFree(size, isVertical, bit)) {
+            hCount = hPlacements > 0 ? FindStart(size, false, -1) : 0;
+            vCount = vPlacements > 0 ? FindStart(size, true, -1) : 0;
+            if (0 == hCount + vCount) {
+                if (++restarts < PLACEMENT_RESTARTS_MAX) {
+                    Init();
+                    i = -1;
+                }
+                continue;
+            }
+            pick = rng.Below(hCount + vCount);
+            isVertical = pick >= hCount;
+            bit = isVertical ? FindStart(size, true, pick - hCount) : FindStart(size, false, pick);
+        }
+
+        PlaceShip(ships[i].name, size, isVertical, bit / _columns, bit % _columns);
+    }
+}
+
+//  Test whether every square of a placement on the grid is free
+//  Parameters:
+//      size - length of the ship
+//      isVertical - orientation
+//      bit - bit number of the start square, the placement is on the grid
+//  Returns:
+//      true if no ship occupies any of its squares
+//  Possible Errors:
+//      none
+bool Grid::IsFree(int size, bool isVertical, int bit) const {
+    const uint64_t* occupied = &_bits[OCCUPIED_BOARD*_words];
+    int step = isVertical ? _columns : 1;
+
+    for (int k = 0; k < size; k ++, bit += step) {
+        if (TestBit(occupied, bit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Scan for the squares where a ship of a given size and orientation can
+//      start, which are the ends of runs of at least size free squares
+//  Parameters:
+//      size - length of the ship
+//      isVertical - orientation
+//      pick - index of the start to find, or -1 to count the starts
+//  Returns:
+//      bit number of the start, or the number of starts if pick is -1
+//  Possible Errors:
+//      none, pick is less than the number of starts
+int Grid::FindStart(int size, bool isVertical, int pick) const {
+    const uint64_t* occupied = &_bits[OCCUPIED_BOARD*_words];
+    int lines = isVertical ? _columns : _rows;
+    int length = isVertical ? _rows : _columns;
+    int along = isVertical ? _columns : 1;
+    int across = isVertical ? 1 : _columns;
+    int count;
+
+    count = 0;
+    for (int line = 0; line < lines; line ++) {
+        int run = 0;
+
+        for (int k = 0; k < length; k ++) {
+            run = TestBit(occupied, line*across + k*along) ? 0 : run + 1;
+            if (run >= size) {
+                if (count == pick) {
+                    return line*across + (k - size + 1)*along;
+                }
+                count ++;
+            }
+        }
+    }
+    return count;
+}
+
+//  Add a ship to the grid
+//  Parameters:
+//      name - name of the ship
+//      size - number of squares it occupies
+//      isVertical - orientation
+//      startRow - row of uppermost/leftmost square
+//      startColumn - column of uppermost/leftmost square
+//  Returns:
+//      true if the ship was added
+//  Possible Errors:
+//      too many ships, ship off grid, ship overlapping another
+bool Grid::AddShip(const string& name, int size, bool isVertical, int startRow, int startColumn) {
+    if (_shipsDeployed >= _shipsMax || size <= 0) {
+        return false;
+    }
+    if (startRow < 0 || startColumn < 0) {
+        return false;
+    }
+    if (isVertical ? startRow + size > _rows || startColumn >= _columns
+                   : startColumn + size > _columns || startRow >= _rows) {
+        return false;
+    }
+
+    // Check for overlap before touching the bitboards
+    if (!IsFree(size, isVertical, startRow*_columns + startColumn)) {
+        return false;
+    }
+
+    PlaceShip(name, size, isVertical, startRow, startColumn);
+    return true;
+}
+
+//  Put a ship on the grid without any checks, the caller has made sure
+//      it is on the grid and does not overlap another ship
+//  Parameters:
+//      name - name of the ship
+//      size - number of squares it occupies
+//      isVertical - orientation
+//      startRow - row of uppermost/leftmost square
+//      startColumn - column of uppermost/leftmost square
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Grid::PlaceShip(const string& name, int size, bool isVertical, int startRow, int startColumn) {
+    uint64_t* occupied = &_bits[OCCUPIED_BOARD*_words];
+    int step;
+    int bit;
+
+    step = isVertical ? _columns : 1;
+    bit = startRow*_columns + startColumn;
+    for (int i = 0; i < size; i ++, bit += step) {
+        SetBit(occupied, bit);
+        _shipIndex[bit] = (unsigned char)_shipsDeployed;
+    }
+    _ships[_shipsDeployed].name = name;
+    _ships[_shipsDeployed].size = size;
+    _ships[_shipsDeployed].isVertical = isVertical;
+    _ships[_shipsDeployed].startRow = startRow;
+    _ships[_shipsDeployed].startColumn = startColumn;
+    _ships[_shipsDeployed].hits = 0;
+    _remaining[_shipsDeployed] = size == 128 ? ~(ShipSquares)0 : ((ShipSquares)1 << size) - 1;
+    _afloat[_shipsDeployed >> 6] |= (uint64_t)1 << (_shipsDeployed & 63);
+    _shipsDeployed ++;
+}
+
+//  Return the number of ships that have been sunk
+//  Parameters:
+//      none
+//  Returns:
+//      count of sunk ships
+//  Possible Errors:
+//      none
+int Grid::GetShipsSunk() const {
+    int afloat = 0;
+
+    for (int i = 0; i < AFLOAT_WORDS; i ++) {
+        afloat += Popcount64(_afloat[i]);
+    }
+    return _shipsDeployed - afloat;
+}
+
+//  Return the number of ships on the grid
+//  Parameters:
+//      none
+//  Returns:
+//      count of deployed ships
+//  Possible Errors:
+//      none
+int Grid::GetShipsDeployed() const {
+    return _shipsDeployed;
+}
+
+//  Retrieve a ship
+//  Parameters:
+//      i - index of the ship (0 <= i < GetShipsDeployed())
+//      ship - receives a copy of the ship
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void Grid::GetShip(int i, Ship& ship) const {
+    ship = _ships[i];
+    ship.hits = ship.size - Popcount64((uint64_t)_remaining[i]) - Popcount64((uint64_t)(_remaining[i] >> 64));
+}
+
+//  Find the ship occupying a square
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      index of the ship, or -1 if there is no ship there
+//  Possible Errors:
+//      none
+int Grid::FindShip(int row, int column) const {
+    unsigned char index;
+
+    if (row < 0 || row >= _rows || column < 0 || column >= _columns) {
+        return -1;
+    }
+    index = _shipIndex[row*_columns + column];
+    return index == NO_SHIP ? -1 : index;
+}
+
+//  Fire a shot at a square
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - receives the outcome of the shot
+//  Returns:
+//      true if the shot was on the grid
+//  Possible Errors:
+//      row or column out of range
+bool Grid::FireShot(int row, int column, Outcome& outcome) {
+    return Fire(row, column, outcome, nullptr);
+}
+
+//  Fire a shot at a square, also reporting which squares changed status
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - receives the outcome of the shot
+//      changes - receives the squares whose status changed
+//  Returns:
+//      true if the shot was on the grid
+//  Possible Errors:
+//      row or column out of range
+bool Grid::FireShot(int row, int column, Outcome& outcome, ShotChanges& changes) {
+    changes.count = 0;
+    return Fire(row, column, outcome, &changes);
+}
+
+//  Fire a shot.  A hit clears the square from its ship's unhit squares;
+//      the ship is sunk when none are left, which relabels all its squares
+//      SUNK, and the game is won when no ship is left afloat
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - receives the outcome of the shot
+//      changes - receives the squares whose status changed, or nullptr
+//  Returns:
+//      true if the shot was on the grid
+//  Possible Errors:
+//      row or column out of range
+bool Grid::Fire(int row, int column, Outcome& outcome, ShotChanges* changes) {
+    uint64_t* shot = &_bits[SHOT_BOARD*_words];
+    uint64_t afloat;
+    int bit;
+    int index;
+    const Ship* ship;
+
+    if (row < 0 || row >= _rows || column < 0 || column >= _columns) {
+        return false;
+    }
+    bit = row*_columns + column;
+    if (TestBit(shot, bit)) {
+        outcome = SHOT_HERE_BEFORE;
+        return true;
+    }
+    SetBit(shot, bit);
+    if (changes) {
+        changes->count = 1;
+        changes->squares[0] = bit;
+    }
+
+    if (!TestBit(&_bits[OCCUPIED_BOARD*_words], bit)) {
+        outcome = SHOT_MISSED;
+        return true;
+    }
+
+    index = _shipIndex[bit];
+    ship = &_ships[index];
+    _remaining[index] &= ~((ShipSquares)1 << (ship->isVertical ? row - ship->startRow : column - ship->startColumn));
+    if (_remaining[index] != 0) {
+        outcome = SHIP_HIT;
+        return true;
+    }
+
+    _afloat[index >> 6] &= ~((uint64_t)1 << (index & 63));
+    if (changes) {
+        changes->count = ship->size;
+        bit = ship->startRow*_columns + ship->startColumn;
+        for (int i = 0; i < ship->size; i ++) {
+            changes->squares[i] = bit;
+            bit += ship->isVertical ? _columns : 1;
+        }
+    }
+    afloat = 0;
+    for (int i = 0; i < AFLOAT_WORDS; i ++) {
+        afloat |= _afloat[i];
+    }
+    outcome = 0 == afloat ? GAME_WON : SHIP_SUNK;
+    return true;
+}
+
+//  Return the status of a square
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      WATER, SHIP, MISS, HIT or SUNK
+//  Possible Errors:
+//      none, out of range squares are reported as WATER
+SquareStatus Grid::GetSquareStatus(int row, int column) const {
+    const uint64_t* shot = &_bits[SHOT_BOARD*_words];
+    int bit;
+
+    if (row < 0 || row >= _rows || column < 0 || column >= _columns) {
+        return WATER;
+    }
+    bit = row*_columns + column;
+    if (TestBit(&_bits[OCCUPIED_BOARD*_words], bit)) {
+        if (!TestBit(shot, bit)) {
+            return SHIP;
+        }
+        return 0 == _remaining[_shipIndex[bit]] ? SUNK : HIT;
+    }
+    return TestBit(shot, bit) ? MISS : WATER;
+}
@@ -10,13 +10,40 @@
 #define BATTLESHIP_GRID_H
 
 #include <fstream>
+#include <vector>
+#include <cstdint>
 #include "battleship.h"
+#include "rng.h"
 
 using namespace std;
 
-// Maximum number of ships on board
+// Maximum number of ships on the classic board
 const int SHIPS_MAX = 5;
 
+// Bitboard layout: square (row, column) is bit row*columns+column,
+// spread across as many 64-bit words as the board needs.  These are
+// the sizes for the classic board
+const int COUNT_SQUARES = COUNT_ROWS*COUNT_COLUMNS;
+const int BOARD_WORDS = (COUNT_SQUARES + 63)/64;
+
+// Marks a square in the ship index map that no ship occupies
+const unsigned char NO_SHIP = 0xFF;
+
+// Limits on the board size and ship count a Grid can be set up with.
+// Ship indices are kept in a byte per square, with NO_SHIP kept free
+const int BOARD_SIDE_MAX = 100;
+const int SHIPS_LIMIT = NO_SHIP;
+
+// Squares of one ship that have not been hit, bit k for its k-th square
+typedef unsigned __int128 ShipSquares;
+static_assert(BOARD_SIDE_MAX <= 128, "a ship must fit in ShipSquares");
+
+// Words in the bitset of ships still afloat
+const int AFLOAT_WORDS = (SHIPS_LIMIT + 63)/64;
+
+// Times RandomlyPlaceShips starts over when the ships do not fit
+const int PLACEMENT_RESTARTS_MAX = 1000;
+
 // Possible states for a square on the grid
 // depending on whether a ship occupies it
 // or a shot has landed there
@@ -25,6 +52,15 @@ enum SquareStatus { WATER, SHIP, MISS, HIT, SUNK };
 // Possible outcomes for a shot
 enum Outcome { SHOT_MISSED, SHIP_HIT, SHIP_SUNK, GAME_WON, SHOT_HERE_BEFORE };
 
+// Squares whose status a shot changed: none if shot before, the square
+// shot for a miss or hit, and every square of the ship once it is sunk
+//      count - number of squares
+//      squares - bit numbers (row*columns+column) of the squares
+struct ShotChanges {
+    int count;
+    int squares[BOARD_SIDE_MAX];
+};
+
 // Describes a ship and its placement on the grid
 //      name - name of ship, its first letter is displayed
 //      size - number of squares it occupies
@@ -32,6 +68,7 @@ enum Outcome { SHOT_MISSED, SHIP_HIT, SHIP_SUNK, GAME_WON, SHOT_HERE_BEFORE };
 //      startRow - row (0-9) of uppermost (if vertical) or leftmost (if horizontal) square it occupies
 //      startColumn - column (0-9) of uppermost (if vertical) or leftmost (if horizontal) square it occupies
 //      hits - number of different squares that ship occupies that have been hit, it's sunk if hits == size
+//             (filled in by GetShip, the grid tracks unhit squares instead)
 struct Ship {
     string name;
     int size;
@@ -41,18 +78,38 @@ struct Ship {
     int hits;
 };
 
+// The ships of the classic game, in the order they are placed
+extern const Ship CLASSIC_SHIPS[];
+extern const int CLASSIC_SHIP_COUNT;
+
 // Describes the state of the grid
+//      rows, columns -- size of the grid, 10x10 unless given to the constructor
+//      shipsMax -- the most ships the grid holds, SHIPS_MAX unless given
+//      words -- number of 64-bit words in each bitboard
 //      ships - the ships placed on teh grid
-//      shipsDeployed -- the number of ships that are on the grip (<= SHIPS_MAX)
-//      shipsSunk -- the number of ships that have been sunk (game is over if == shipsDeployed)
+//      shipsDeployed -- the number of ships that are on the grip (<= shipsMax)
+//      bits -- the occupied and shot bitboards back to back: squares
+//          covered by a ship and squares a shot has landed on
+//      remaining -- per ship, its squares that have not been hit; the ship
+//          is sunk when this is zero, which makes its squares SUNK
+//      afloat -- bitset of the ships not sunk, the game is won when empty
+//      shipIndex -- per square index into ships, or NO_SHIP
+//  The classic 10x10 board keeps its whole-board mask fast path for
+//  random placement; other sizes scan runs of free squares.
 class Grid {
 public:
     Grid();
+    Grid(int rows, int columns, int shipsMax = SHIPS_MAX);
 
+    int GetRows() const;
+    int GetColumns() const;
+    int GetShipsMax() const;
+
+    void Init();
     bool LoadShips(ifstream& file);
     bool SaveShips(ofstream& file);
 
-    void RandomlyPlaceShips(const Ship ships[], int shipCount);
+    void RandomlyPlaceShips(const Ship ships[], int shipCount, Rng& rng);
 
     bool AddShip(const string& name, int size, bool isVertical, int startRow, int startColumn);
     int GetShipsSunk() const;
@@ -61,16 +118,89 @@ public:
     int FindShip(int row, int column) const;
 
     bool FireShot(int row, int column, Outcome& outcome);
+    bool FireShot(int row, int column, Outcome& outcome, ShotChanges& changes);
 
     SquareStatus GetSquareStatus(int row, int column) const;
 
 private:
-    void Init();
-
-    Ship _ships[SHIPS_MAX];
+    void PlaceShip(const string& name, int size, bool isVertical, int startRow, int startColumn);
+    void PlaceShipsClassic(const Ship ships[], int shipCount, Rng& rng);
+    void PlaceShipsAnySize(const Ship ships[], int shipCount, Rng& rng);
+    bool IsFree(int size, bool isVertical, int bit) const;
+    int FindStart(int size, bool isVertical, int pick) const;
+    bool Fire(int row, int column, Outcome& outcome, ShotChanges* changes);
+
+    int _rows;
+    int _columns;
+    int _shipsMax;
+    int _words;
+    vector<Ship> _ships;
     int _shipsDeployed;
-    int _shipsSunk;
-    SquareStatus _squareStatus[COUNT_ROWS][COUNT_COLUMNS];
+    vector<uint64_t> _bits;
+    vector<ShipSquares> _remaining;
+    uint64_t _afloat[AFLOAT_WORDS];
+    vector<unsigned char> _shipIndex;
 };
 
+//  Read a ship configuration into an empty grid.  The file contains the
+//      number of ships, followed by each ship's name on a line by itself
+//      and then a line with its size, isVertical, startRow and startColumn.
+//      Shared by Grid and FixedGrid through their public methods
+//  Parameters:
+//      file - input file stream
+//      grid - grid to add the ships to
+//  Returns:
+//      true if all ships were read and placed
+//  Possible Errors:
+//      badly formatted file, too many ships, ships off grid or overlapping
+template <class GridType>
+bool ReadShips(ifstream& file, GridType& grid) {
+    int count;
+
+    if (!(file >> count) || count < 0 || count > grid.GetShipsMax()) {
+        return false;
+    }
+    for (int i = 0; i < count; i ++) {
+        string name;
+        int size;
+        bool isVertical;
+        int startRow;
+        int startColumn;
+
+        file >> ws;
+        if (!getline(file, name)) {
+            return false;
+        }
+        if (!(file >> size >> isVertical >> startRow >> startColumn)) {
+            return false;
+        }
+        if (!grid.AddShip(name, size, isVertical, startRow, startColumn)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Write the ship configuration of a grid in the format read by ReadShips
+//  Parameters:
+//      file - output file stream
+//      grid - grid whose ships are written
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      write failure
+template <class GridType>
+bool WriteShips(ofstream& file, const GridType& grid) {
+    file << grid.GetShipsDeployed() << endl;
+    for (int i = 0; i < grid.GetShipsDeployed(); i ++) {
+        Ship ship;
+
+        grid.GetShip(i, ship);
+        file << ship.name << endl;
+        file << ship.size << " " << ship.isVertical << " "
+             << ship.startRow << " " << ship.startColumn << endl;
+    }
+    return !file.fail();
+}
+
 #endif //BATTLESHIP_GRID_H
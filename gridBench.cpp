@@ -0,0 +1,87 @@
+// Title: Lab 6 - gridBench.cpp
+//
+// Purpose: Compare the runtime sized Grid against the compile-time
+//          specialized ClassicGrid on the simulator's hot loop: place the
+//          classic ships, then fire at every square in random order until
+//          the game is won.  Both grids are driven by the same random
+//          numbers, so they must agree shot for shot.
+//
+//          Usage: GridBench [games]
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "fixedGrid.h"
+
+using namespace std;
+
+const long DEFAULT_GAMES = 1000000;
+const uint64_t SEED = 2020;
+
+//  Play games against a shuffled firing order
+//  Parameters:
+//      games - number of games
+//      checksum - receives the total shots plus the squares seen as hit
+//  Returns:
+//      seconds taken
+//  Possible Errors:
+//      none
+template <class GridType>
+double PlayGames(long games, long& checksum) {
+    GridType grid;
+    Rng rng(SEED);
+    int order[COUNT_SQUARES];
+    chrono::steady_clock::time_point start;
+
+    checksum = 0;
+    start = chrono::steady_clock::now();
+    for (long game = 0; game < games; game ++) {
+        Outcome outcome;
+
+        grid.RandomlyPlaceShips(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, rng);
+        for (int i = 0; i < COUNT_SQUARES; i ++) {
+            int j = rng.Below(i + 1);
+
+            order[i] = order[j];
+            order[j] = i;
+        }
+        outcome = SHOT_MISSED;
+        for (int i = 0; i < COUNT_SQUARES && outcome != GAME_WON; i ++) {
+            int row = order[i] / COUNT_COLUMNS;
+            int column = order[i] % COUNT_COLUMNS;
+
+            grid.FireShot(row, column, outcome);
+            checksum += 1 + (grid.GetSquareStatus(row, column) >= HIT);
+        }
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    long games;
+    long genericChecksum;
+    long classicChecksum;
+    double genericSeconds;
+    double classicSeconds;
+
+    games = argc > 1 ? atol(argv[1]) : DEFAULT_GAMES;
+    if (games <= 0) {
+        cerr << "Usage: " << argv[0] << " [games]" << endl;
+        return 1;
+    }
+    genericSeconds = PlayGames<Grid>(games, genericChecksum);
+    classicSeconds = PlayGames<ClassicGrid>(games, classicChecksum);
+    if (genericChecksum != classicChecksum) {
+        cerr << "Mismatch: Grid " << genericChecksum << ", ClassicGrid " << classicChecksum << endl;
+        return 1;
+    }
+    cout << fixed << setprecision(0);
+    cout << "Grid:         " << setw(10) << games/genericSeconds << " games/second" << endl;
+    cout << "ClassicGrid:  " << setw(10) << games/classicSeconds << " games/second" << endl;
+    cout << setprecision(2) << "Speedup:      " << setw(10) << genericSeconds/classicSeconds << "x" << endl;
+    return 0;
+}
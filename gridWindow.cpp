@@ -9,9 +9,45 @@
 #include <assert.h>
 #include "gridWindow.h"
 
-// Grid Titles
-const string HTITLE = "A B C D E F G H I J";
-const string VTITLE = "0 1 2 3 4 5 6 7 8 9";
+//  Build the title labeling the columns of a grid, one character per
+//      column with a space between.  Columns are lettered when there are
+//      at most 26 of them, otherwise numbered by their last digit
+//  Parameters:
+//      columns - number of columns
+//  Returns:
+//      the title
+//  Possible Errors:
+//      none
+static string ColumnTitle(int columns) {
+    string title;
+
+    for (int c = 0; c < columns; c ++) {
+        if (c > 0) {
+            title += ' ';
+        }
+        title += columns <= 26 ? (char)('A' + c) : (char)('0' + c % 10);
+    }
+    return title;
+}
+
+//  Build the title labeling the rows of a grid by their last digit
+//  Parameters:
+//      rows - number of rows
+//  Returns:
+//      the title
+//  Possible Errors:
+//      none
+static string RowTitle(int rows) {
+    string title;
+
+    for (int r = 0; r < rows; r ++) {
+        if (r > 0) {
+            title += ' ';
+        }
+        title += (char)('0' + r % 10);
+    }
+    return title;
+}
 
 // Implement the GridWindow class which bundles the behind the scenes Grid
 //          class functionality with the display elements.
@@ -19,9 +55,12 @@ const string VTITLE = "0 1 2 3 4 5 6 7 8 9";
 
 //
 //  Constructor
-GridWindow::GridWindow(string title, bool isUser) :
-    _plot("Plot", HEIGHT, WIDTH),
-    _plotWithLabels("PlotWithLabels", true, HTITLE, VTITLE),
+//      The grid is rows x columns (clamped as by Grid) and holds up to
+//      shipsMax ships
+GridWindow::GridWindow(string title, bool isUser, int rows, int columns, int shipsMax) :
+    _grid(rows, columns, shipsMax),
+    _plot("Plot", 2*_grid.GetRows()+1, 2*_grid.GetColumns()+1),
+    _plotWithLabels("PlotWithLabels", true, ColumnTitle(_grid.GetColumns()), RowTitle(_grid.GetRows())),
     _labeledPlotWithTitle("LabeledPlotWithTitle", false, title) {
     _isUser = isUser;
     assert(5 == COLORS_MAX);
@@ -57,7 +96,7 @@ VGroup& GridWindow::DisplayArea() {
     return _labeledPlotWithTitle;
 }
 
-//  Display the grid lines
+//  Display the grid lines, one run of cells per row
 //  Parameters:
 //      none
 //  Returns:
@@ -65,16 +104,20 @@ VGroup& GridWindow::DisplayArea() {
 //  Possible Errors:
 //      none expected
 void GridWindow::DisplayLines() {
+    int height = 2*_grid.GetRows() + 1;
+    int width = 2*_grid.GetColumns() + 1;
+    vector<chtype> line(width);
+
     // Display the grid
-    for (int row = 0; row < HEIGHT; row ++) {
-        for (int col = 0; col < WIDTH; col ++) {
+    for (int row = 0; row < height; row ++) {
+        for (int col = 0; col < width; col ++) {
             chtype ch;
 
             if (0 == col)  {
                 if (row == 0) {
                     ch = ACS_ULCORNER;
                 }
-                else if (row == HEIGHT-1) {
+                else if (row == height-1) {
                     ch = ACS_LLCORNER;
                 }
                 else if (row % 2 == 0) {
@@ -83,13 +126,12 @@ void GridWindow::DisplayLines() {
                 else {
                     ch = ACS_VLINE;
                 }
-                _plot.Write(col, row, ch);
             }
-            else if (col == WIDTH-1) {
+            else if (col == width-1) {
                 if (row == 0) {
                     ch = ACS_URCORNER;
                 }
-                else if (row == HEIGHT-1) {
+                else if (row == height-1) {
                     ch = ACS_LRCORNER;
                 }
                 else if (row % 2 == 0) {
@@ -98,12 +140,9 @@ void GridWindow::DisplayLines() {
                 else {
                     ch = ACS_VLINE;
                 }
-                _plot.Write(col, row, ch);
             }
             else if (row % 2 == 1) {
-                if (col % 2 == 0) {
-                    _plot.Write(col, row, ACS_VLINE);
-                }
+                ch = col % 2 == 0 ? ACS_VLINE : ' ';
             }
             else {
                 if (col % 2 == 1) {
@@ -112,21 +151,23 @@ void GridWindow::DisplayLines() {
                 else if (row == 0) {
                     ch = ACS_TTEE;
                 }
-                else if (row == HEIGHT-1) {
+                else if (row == height-1) {
                     ch = ACS_BTEE;
                 }
                 else {
                     ch = ACS_PLUS;
                 }
-                _plot.Write(col, row, ch);
             }
+            line[col] = ch;
         }
+        _plot.WriteRun(0, row, line.data(), width);
     }
 }
 
 // Your work starts below this line...
 
-//  Display the initial state of the grid
+//  Display the initial state of the grid.  The grid lines are saved as the
+//      plot's background so they are sent to the terminal only once.
 //  Parameters:
 //      none
 //  Returns:
@@ -134,11 +175,15 @@ void GridWindow::DisplayLines() {
 //  Possible Errors:
 //      none expected
 void GridWindow::Display() {
-    // You need to add code here
+    DisplayLines();
+    _plot.SaveBackground();
+    DisplaySquares();
+    _plot.Refresh();
 }
 
 //  Fire at a square of the grid.  This method both updates the in memory Grid
-//      class and also displays the shot in the UI
+//      class and also displays the shot in the UI.  Only the squares the
+//      grid reports as changed are redrawn
 //  Parameters:
 //      row - row number of the shot
 //      column - column number of the shot
@@ -146,10 +191,128 @@ void GridWindow::Display() {
 //  Returns:
 //      success/failure
 //  Possible Errors:
-//      none expected
+//      square is off the grid
 bool GridWindow::FireShot(int row, int column, Outcome& outcome) {
-    // You need to add code here
+    ShotChanges changes;
+    int columns = _grid.GetColumns();
+
+    if (!_grid.FireShot(row, column, outcome, changes)) {
+        return false;
+    }
+    for (int i = 0; i < changes.count; i ++) {
+        int r = changes.squares[i] / columns;
+        int c = changes.squares[i] % columns;
+
+        _plot.Write(2*c+1, 2*r+1, SquareCell(r, c));
+    }
+    _plot.Refresh();
     return true;
 }
 
-// For you to add:  LoadShips, RandomlyPlaceShips, DisplayShip
+//  Load the ship layout from a file
+//  Parameters:
+//      file - stream to read the layout from
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      badly formed layout
+bool GridWindow::LoadShips(ifstream& file) {
+    return _grid.LoadShips(file);
+}
+
+//  Place the ships of the classic game randomly
+//  Parameters:
+//      rng - random number generator to use
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void GridWindow::RandomlyPlaceShips(Rng& rng) {
+    _grid.RandomlyPlaceShips(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, rng);
+}
+
+//  Return the game state
+//  Parameters:
+//      none
+//  Returns:
+//      reference to the grid
+//  Possible Errors:
+//      none
+const Grid& GridWindow::GetGrid() const {
+    return _grid;
+}
+
+//  Replace the game state, e.g. with a snapshot of a replayed game, and
+//      redraw the squares.  Only the squares that differ from what is shown
+//      are sent to the terminal
+//  Parameters:
+//      grid - the new state, the same size as the current grid
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      grid of a different size
+bool GridWindow::SetGrid(const Grid& grid) {
+    if (grid.GetRows() != _grid.GetRows() || grid.GetColumns() != _grid.GetColumns()) {
+        return false;
+    }
+    _grid = grid;
+    DisplaySquares();
+    _plot.Refresh();
+    return true;
+}
+
+//  Display every square of the grid, one run of cells per row with the
+//      grid lines between the squares included
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void GridWindow::DisplaySquares() {
+    int columns = _grid.GetColumns();
+    vector<chtype> run(2*columns-1, ACS_VLINE);
+
+    for (int row = 0; row < _grid.GetRows(); row ++) {
+        for (int column = 0; column < columns; column ++) {
+            run[2*column] = SquareCell(row, column);
+        }
+        _plot.WriteRun(1, 2*row+1, run.data(), (int)run.size());
+    }
+}
+
+//  Determine how a square is drawn.  Misses are an X.  On the user's grid
+//      every ship square is shown with the ship's letter; on the CPU's grid
+//      only squares that have been hit are shown, with the letter once the
+//      ship is sunk.  Squares that have been hit use RED_INVERSE, the others
+//      the color of their ship
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      the cell to write
+//  Possible Errors:
+//      none expected
+chtype GridWindow::SquareCell(int row, int column) {
+    SquareStatus status = _grid.GetSquareStatus(row, column);
+    int index;
+    Ship ship;
+    chtype letter;
+
+    if (MISS == status) {
+        return 'X';
+    }
+    index = _grid.FindShip(row, column);
+    if (index < 0) {
+        return ' ';
+    }
+    _grid.GetShip(index, ship);
+    letter = ship.name.empty() ? '?' : ship.name[0];
+    if (HIT == status) {
+        return PlotWindow::MakeCell(_isUser ? letter : ' ', RED_INVERSE);
+    }
+    if (SUNK == status) {
+        return PlotWindow::MakeCell(letter, RED_INVERSE);
+    }
+    return _isUser ? PlotWindow::MakeCell(letter, _colors[index % COLORS_MAX]) : ' ';
+}
@@ -18,11 +18,12 @@ const int COLORS_MAX = SHIPS_MAX;
 //      elements
 class GridWindow {
 public:
-    GridWindow(string title, bool isUser);
+    GridWindow(string title, bool isUser,
+               int rows = COUNT_ROWS, int columns = COUNT_COLUMNS, int shipsMax = SHIPS_MAX);
 
     // Ship placement
     bool LoadShips(ifstream& file);
-    void RandomlyPlaceShips();
+    void RandomlyPlaceShips(Rng& rng);
 
     // Two-stage initialization of the display
     void Init();
@@ -32,10 +33,18 @@ public:
     // Firing shots
     bool FireShot(int row, int column, Outcome& outcome);
 
+    // Game state, for saving and restoring it
+    const Grid& GetGrid() const;
+    bool SetGrid(const Grid& grid);
+
 private:
     // Submethods called by Display method
     void DisplayLines();
-    void DisplayShip(const Ship& ship, int color=DEFAULT_COLOR);
+    void DisplaySquares();
+    chtype SquareCell(int row, int column);
+
+    // Game state, constructed first since it sizes the display
+    Grid _grid;
 
     // User interface elements
     PlotWindow _plot;
@@ -43,9 +52,6 @@ private:
     VGroup _labeledPlotWithTitle;
     int _colors[COLORS_MAX];
 
-    // Game state
-    Grid _grid;
-
     // Who am I?
     bool _isUser;
 };
@@ -0,0 +1,193 @@
+// Title: Lab 6 - heatmap.cpp
+//
+// Purpose: Implements the Heatmap class declared in heatmap.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <cstring>
+#include "heatmap.h"
+
+//
+//  Constructor
+Heatmap::Heatmap() {
+    Clear();
+}
+
+//  Forget every layout counted
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Heatmap::Clear() {
+    _layouts = 0;
+    memset(_counts, 0, sizeof(_counts));
+    memset(_totals, 0, sizeof(_totals));
+}
+
+//  Count the placements of a layout.  The ships must be on the grid and
+//      must not overlap, or nothing is counted
+//  Parameters:
+//      ships - the ships of the layout
+//      shipCount - number of elements in ships
+//  Returns:
+//      true if the layout was counted
+//  Possible Errors:
+//      a ship too long or too short, off the grid or overlapping another
+bool Heatmap::Add(const Ship ships[], int shipCount) {
+    bool occupied[COUNT_SQUARES];
+
+    memset(occupied, 0, sizeof(occupied));
+    for (int i = 0; i < shipCount; i ++) {
+        const Ship& ship = ships[i];
+        int step = ship.isVertical ? COUNT_COLUMNS : 1;
+        int square = ship.startRow*COUNT_COLUMNS + ship.startColumn;
+
+        if (ship.size < 1 || ship.size > HEATMAP_LENGTH_MAX
+            || ship.startRow < 0 || ship.startColumn < 0
+            || (ship.isVertical ? ship.startRow + ship.size > COUNT_ROWS : ship.startRow >= COUNT_ROWS)
+            || (ship.isVertical ? ship.startColumn >= COUNT_COLUMNS : ship.startColumn + ship.size > COUNT_COLUMNS)) {
+            return false;
+        }
+        for (int k = 0; k < ship.size; k ++, square += step) {
+            if (occupied[square]) {
+                return false;
+            }
+            occupied[square] = true;
+        }
+    }
+    for (int i = 0; i < shipCount; i ++) {
+        const Ship& ship = ships[i];
+
+        _counts[ship.size][(ship.isVertical ? COUNT_SQUARES : 0) + ship.startRow*COUNT_COLUMNS + ship.startColumn] ++;
+        _totals[ship.size] ++;
+    }
+    _layouts ++;
+    return true;
+}
+
+//  Add the counts of another model into this one
+//  Parameters:
+//      other - model to add
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Heatmap::Merge(const Heatmap& other) {
+    _layouts += other._layouts;
+    for (int len = 0; len <= HEATMAP_LENGTH_MAX; len ++) {
+        for (int p = 0; p < HEATMAP_PLACEMENTS; p ++) {
+            _counts[len][p] += other._counts[len][p];
+        }
+        _totals[len] += other._totals[len];
+    }
+}
+
+//  Read a model file
+//  Parameters:
+//      fileName - name of the file
+//  Returns:
+//      success/failure, the model is empty on failure
+//  Possible Errors:
+//      file cannot be read, wrong magic or version, trained on another
+//      grid size, wrong length
+bool Heatmap::Load(const string& fileName) {
+    ifstream file(fileName, ios::binary);
+    HeatmapHeader header;
+
+    Clear();
+    if (!file.read((char*)&header, sizeof(header))
+        || memcmp(header.magic, HEATMAP_MAGIC, sizeof(HEATMAP_MAGIC)) != 0
+        || header.version != HEATMAP_VERSION
+        || header.rows != COUNT_ROWS || header.columns != COUNT_COLUMNS
+        || header.lengthMax != HEATMAP_LENGTH_MAX
+        || !file.read((char*)_counts[1], HEATMAP_LENGTH_MAX*sizeof(_counts[1]))
+        || file.peek() != EOF) {
+        Clear();
+        return false;
+    }
+    _layouts = header.layouts;
+    for (int len = 1; len <= HEATMAP_LENGTH_MAX; len ++) {
+        for (int p = 0; p < HEATMAP_PLACEMENTS; p ++) {
+            _totals[len] += _counts[len][p];
+        }
+    }
+    return true;
+}
+
+//  Write the model to a file
+//  Parameters:
+//      fileName - name of the file
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be created or written
+bool Heatmap::Save(const string& fileName) const {
+    ofstream file(fileName, ios::binary | ios::trunc);
+    HeatmapHeader header;
+
+    if (!file.is_open()) {
+        return false;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HEATMAP_MAGIC, sizeof(HEATMAP_MAGIC));
+    header.version = HEATMAP_VERSION;
+    header.rows = COUNT_ROWS;
+    header.columns = COUNT_COLUMNS;
+    header.lengthMax = HEATMAP_LENGTH_MAX;
+    header.layouts = _layouts;
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)_counts[1], HEATMAP_LENGTH_MAX*sizeof(_counts[1]));
+    file.close();
+    return !file.fail();
+}
+
+//  Return the number of layouts counted
+uint64_t Heatmap::GetLayouts() const {
+    return _layouts;
+}
+
+//  Return how many times a placement was counted
+//  Parameters:
+//      length - length of the ship (1 <= length <= HEATMAP_LENGTH_MAX)
+//      isVertical - orientation of the ship
+//      square - start square, row*COUNT_COLUMNS + column
+//  Returns:
+//      the count
+//  Possible Errors:
+//      none expected
+uint64_t Heatmap::GetCount(int length, bool isVertical, int square) const {
+    return _counts[length][(isVertical ? COUNT_SQUARES : 0) + square];
+}
+
+//  Return the prior weight of a placement: HEATMAP_PRIOR_ONE times how
+//      much more often ships of its length were placed there than if
+//      every placement on the grid were equally likely, smoothed by
+//      HEATMAP_PSEUDOCOUNT
+//  Parameters:
+//      length - length of the ship (1 <= length <= HEATMAP_LENGTH_MAX)
+//      isVertical - orientation of the ship
+//      square - start square of a placement that fits on the grid
+//  Returns:
+//      the prior, HEATMAP_PRIOR_ONE if no ship of the length was counted
+//  Possible Errors:
+//      none expected
+int Heatmap::GetPrior(int length, bool isVertical, int square) const {
+    int placements;
+    double mean;
+    double prior;
+
+    if (0 == _totals[length]) {
+        return HEATMAP_PRIOR_ONE;
+    }
+    placements = COUNT_ROWS*(COUNT_COLUMNS - length + 1) + (COUNT_ROWS - length + 1)*COUNT_COLUMNS;
+    mean = (double)_totals[length] / placements;
+    prior = HEATMAP_PRIOR_ONE * (GetCount(length, isVertical, square) + HEATMAP_PSEUDOCOUNT)
+            / (mean + HEATMAP_PSEUDOCOUNT);
+    if (prior < 1) {
+        return 1;
+    }
+    return prior > HEATMAP_PRIOR_MAX ? HEATMAP_PRIOR_MAX : (int)(prior + 0.5);
+}
@@ -0,0 +1,82 @@
+// Title: Lab 6 - heatmap.h
+//
+// Purpose: Declares the Heatmap class, a model of where opponents place
+//          their ships learned from saved layouts, and its file format.
+//
+//          The model counts, for each ship length, how many of the
+//          layouts it was trained on had a ship of that length at each
+//          placement (orientation and start square).  A model file is a
+//          fixed size header followed by the counts, and it is small
+//          enough to be read whole at startup.
+//
+//          Multi-byte fields are stored little-endian.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_HEATMAP_H
+#define BATTLESHIP_HEATMAP_H
+
+#include <cstdint>
+#include <string>
+#include "grid.h"
+
+// Format identification
+const char HEATMAP_MAGIC[4] = { 'B', 'S', 'H', 'M' };
+const uint16_t HEATMAP_VERSION = 1;
+
+// Longest ship the model counts
+const int HEATMAP_LENGTH_MAX = COUNT_ROWS > COUNT_COLUMNS ? COUNT_ROWS : COUNT_COLUMNS;
+
+// Placements of one length: horizontal then vertical, by start square
+const int HEATMAP_PLACEMENTS = 2*COUNT_SQUARES;
+
+// A prior is the weight of a placement relative to HEATMAP_PRIOR_ONE for
+// one as likely as under uniform placement, between 1 and HEATMAP_PRIOR_MAX
+const int HEATMAP_PRIOR_ONE = 16;
+const int HEATMAP_PRIOR_MAX = 255;
+
+// Layouts added to every placement of a length so rare ones keep some weight
+const double HEATMAP_PSEUDOCOUNT = 16;
+
+// Header at the start of a model file
+//      magic - HEATMAP_MAGIC
+//      version - HEATMAP_VERSION
+//      rows, columns - grid the layouts were placed on
+//      lengthMax - HEATMAP_LENGTH_MAX, the counts are for lengths 1 to it
+//      reserved - zero
+//      layouts - number of layouts the model was trained on
+// The counts follow as uint64_t, per length then per placement
+struct HeatmapHeader {
+    char magic[4];
+    uint16_t version;
+    uint8_t rows;
+    uint8_t columns;
+    uint8_t lengthMax;
+    uint8_t reserved[7];
+    uint64_t layouts;
+};
+
+//  Counts of the placements of each ship length over a set of layouts
+class Heatmap {
+public:
+    Heatmap();
+
+    void Clear();
+    bool Add(const Ship ships[], int shipCount);
+    void Merge(const Heatmap& other);
+
+    bool Load(const string& fileName);
+    bool Save(const string& fileName) const;
+
+    uint64_t GetLayouts() const;
+    uint64_t GetCount(int length, bool isVertical, int square) const;
+    int GetPrior(int length, bool isVertical, int square) const;
+
+private:
+    uint64_t _layouts;
+    uint64_t _counts[HEATMAP_LENGTH_MAX+1][HEATMAP_PLACEMENTS];
+    uint64_t _totals[HEATMAP_LENGTH_MAX+1];     // placements counted per length
+};
+
+#endif //BATTLESHIP_HEATMAP_H
@@ -0,0 +1,371 @@
+// Title: Lab 6 - layoutValidator.cpp
+//
+// Purpose: Implements the LayoutValidator class which checks a stream of
+//          ship layouts in the text format read by Grid::LoadShips without
+//          holding the stream in memory.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include "layoutValidator.h"
+
+// Descriptions of the layout errors, indexed by LayoutError
+static const char* const ERROR_TEXT[] = {
+    "ok", "syntax error", "too many ships", "bad ship size",
+    "ship off grid", "ships overlap", "truncated layout"
+};
+
+// Counts above this are taken as garbage rather than a layout
+const int COUNT_SANE_MAX = 255;
+
+// Longest number accepted
+const int DIGITS_MAX = 9;
+
+//  Test for the whitespace characters skipped by operator>>
+static inline bool IsSpace(char c) {
+    return ' ' == c || '\n' == c || '\t' == c || '\r' == c || '\v' == c || '\f' == c;
+}
+
+//
+//  Constructor
+//  Parameters:
+//      report - stream every bad layout is written to
+//      sink - receiver of every good layout, or nullptr for none
+LayoutValidator::LayoutValidator(ostream& report, LayoutSink* sink) : _report(report) {
+    _sink = sink;
+    _offset = 0;
+    _state = EXPECT_COUNT;
+    _afterNumber = EXPECT_COUNT;
+    _value = 0;
+    _negative = false;
+    _hasDigits = false;
+    _layoutStart = 0;
+    _count = 0;
+    _ship = 0;
+    _field = 0;
+    _occupied = 0;
+    _error = LAYOUT_OK;
+    _errorShip = 0;
+    _lineLength = 0;
+    _lineStart = 0;
+    _layouts = 0;
+    _badLayouts = 0;
+}
+
+//  Check the next chunk of the stream
+//  Parameters:
+//      data - the chunk
+//      length - number of bytes in the chunk
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none, problems are written to the report stream
+void LayoutValidator::Feed(const char* data, size_t length) {
+    for (size_t i = 0; i < length; i ++, _offset ++) {
+        char c = data[i];
+
+        switch (_state) {
+            case EXPECT_COUNT:
+            case EXPECT_FIELD:
+                if (IsSpace(c)) {
+                    break;
+                }
+                if (EXPECT_COUNT == _state) {
+                    _layoutStart = _offset;
+                }
+                if ((c >= '0' && c <= '9') || '-' == c || '+' == c) {
+                    _afterNumber = _state;
+                    _state = IN_NUMBER;
+                    _value = c >= '0' ? c - '0' : 0;
+                    _negative = '-' == c;
+                    _hasDigits = c >= '0';
+                    _field = EXPECT_COUNT == _afterNumber ? 0 : _field;
+                    break;
+                }
+                if (EXPECT_COUNT == _state) {
+                    _count = 0;
+                    _ship = 0;
+                }
+                Fail(LAYOUT_SYNTAX);
+                EndLayout();
+                break;
+
+            case IN_NUMBER:
+                if (c >= '0' && c <= '9' && _value < 100000000) {
+                    _value = _value*10 + (c - '0');
+                    _hasDigits = true;
+                }
+                else if (IsSpace(c) && _hasDigits) {
+                    EndNumber();
+                    if (RESYNC == _state && '\n' == c) {
+                        _lineLength = 0;
+                        _lineStart = _offset + 1;
+                    }
+                }
+                else {
+                    Fail(LAYOUT_SYNTAX);
+                    EndLayout();
+                    if ('\n' == c) {
+                        _lineLength = 0;
+                        _lineStart = _offset + 1;
+                    }
+                }
+                break;
+
+            case EXPECT_NAME:
+                if (!IsSpace(c)) {
+                    _state = IN_NAME;
+                }
+                break;
+
+            case IN_NAME:
+                if ('\n' == c) {
+                    _state = EXPECT_FIELD;
+                }
+                break;
+
+            case RESYNC:
+                if ('\n' == c) {
+                    ResyncLine();
+                }
+                else if (_lineLength >= 0) {
+                    if (_lineLength < RESYNC_LINE_MAX) {
+                        _line[_lineLength++] = c;
+                    }
+                    else {
+                        _lineLength = -1;
+                    }
+                }
+                break;
+        }
+    }
+}
+
+//  Signal the end of the stream, checking the last layout
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none, problems are written to the report stream
+void LayoutValidator::Finish() {
+    if (IN_NUMBER == _state) {
+        if (_hasDigits) {
+            EndNumber();
+        }
+        else {
+            Fail(LAYOUT_SYNTAX);
+            EndLayout();
+        }
+    }
+    if (RESYNC == _state) {
+        ResyncLine();
+    }
+    if (EXPECT_COUNT != _state && RESYNC != _state) {
+        Fail(LAYOUT_TRUNCATED);
+        EndLayout();
+    }
+}
+
+//  Return the number of layouts seen
+long LayoutValidator::GetLayouts() const {
+    return _layouts;
+}
+
+//  Return the number of bad layouts seen
+long LayoutValidator::GetBadLayouts() const {
+    return _badLayouts;
+}
+
+//  Return the number of bytes checked
+unsigned long long LayoutValidator::GetBytes() const {
+    return _offset;
+}
+
+//  Begin a layout once its ship count has been read
+//  Parameters:
+//      count - number of ships
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void LayoutValidator::StartLayout(int count) {
+    _count = count;
+    _ship = 0;
+    _field = 0;
+    _occupied = 0;
+    _error = LAYOUT_OK;
+    if (count > SHIPS_MAX) {
+        Fail(LAYOUT_TOO_MANY);
+    }
+    if (0 == count) {
+        EndLayout();
+    }
+    else {
+        _state = EXPECT_NAME;
+    }
+}
+
+//  A number has been read, use it for the count or a ship field
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void LayoutValidator::EndNumber() {
+    int value = (int)(_negative ? -_value : _value);
+
+    if (EXPECT_COUNT == _afterNumber) {
+        if (value < 0 || value > COUNT_SANE_MAX) {
+            _count = 0;
+            _ship = 0;
+            Fail(LAYOUT_SYNTAX);
+            EndLayout();
+            return;
+        }
+        StartLayout(value);
+        return;
+    }
+
+    _fields[_field++] = value;
+    _state = EXPECT_FIELD;
+    if (4 == _field) {
+        CheckShip();
+        _field = 0;
+        if (++_ship == _count) {
+            EndLayout();
+        }
+        else {
+            _state = EXPECT_NAME;
+        }
+    }
+}
+
+//  Check the ship just read against the grid and the earlier ships
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void LayoutValidator::CheckShip() {
+    int size = _fields[0];
+    int isVertical = _fields[1];
+    int row = _fields[2];
+    int column = _fields[3];
+    BoardMask ship;
+
+    if (isVertical != 0 && isVertical != 1) {
+        Fail(LAYOUT_SYNTAX);
+        return;
+    }
+    if (size <= 0) {
+        Fail(LAYOUT_BAD_SIZE);
+        return;
+    }
+    if (row < 0 || column < 0
+        || (isVertical ? row + size > COUNT_ROWS || column >= COUNT_COLUMNS
+                       : column + size > COUNT_COLUMNS || row >= COUNT_ROWS)) {
+        Fail(LAYOUT_OFF_GRID);
+        return;
+    }
+    ship = (isVertical ? Masks().vShip[size] : Masks().hShip[size]) << (row*COUNT_COLUMNS + column);
+    if ((ship & _occupied) != 0) {
+        Fail(LAYOUT_OVERLAP);
+    }
+    _occupied |= ship;
+    if (_ship < SHIPS_MAX) {
+        _ships[_ship].size = size;
+        _ships[_ship].isVertical = isVertical != 0;
+        _ships[_ship].startRow = row;
+        _ships[_ship].startColumn = column;
+        _ships[_ship].hits = 0;
+    }
+}
+
+//  Finish a layout, handing it to the sink if it is good and reporting it
+//      if anything was wrong.  After a syntax error the rest of the current
+//      line is skipped and resyncing starts
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void LayoutValidator::EndLayout() {
+    _layouts ++;
+    if (LAYOUT_OK == _error && _sink) {
+        _sink->Layout(_ships, _count);
+    }
+    if (_error != LAYOUT_OK) {
+        _badLayouts ++;
+        _report << "offset " << _layoutStart << ": layout " << _layouts - 1 << ": "
+                << ERROR_TEXT[_error];
+        if (_error != LAYOUT_SYNTAX && _error != LAYOUT_TRUNCATED && _errorShip < _count) {
+            _report << " (ship " << _errorShip << ")";
+        }
+        _report << endl;
+    }
+    if (LAYOUT_SYNTAX == _error && _state != RESYNC) {
+        _state = RESYNC;
+        _lineLength = -1;
+    }
+    else {
+        _state = EXPECT_COUNT;
+    }
+    _error = LAYOUT_OK;
+}
+
+//  Remember the first problem found in the current layout
+//  Parameters:
+//      error - the problem
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void LayoutValidator::Fail(LayoutError error) {
+    if (LAYOUT_OK == _error) {
+        _error = error;
+        _errorShip = _ship;
+    }
+}
+
+//  While resyncing, a line has ended.  If it holds nothing but a count it
+//      starts the next layout
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void LayoutValidator::ResyncLine() {
+    int i;
+    int count;
+    int digits;
+
+    if (_lineLength > 0) {
+        count = 0;
+        digits = 0;
+        i = 0;
+        while (i < _lineLength && IsSpace(_line[i])) {
+            i ++;
+        }
+        while (i < _lineLength && _line[i] >= '0' && _line[i] <= '9' && digits < DIGITS_MAX) {
+            count = count*10 + (_line[i++] - '0');
+            digits ++;
+        }
+        while (i < _lineLength && IsSpace(_line[i])) {
+            i ++;
+        }
+        if (digits > 0 && i == _lineLength && count <= COUNT_SANE_MAX) {
+            _layoutStart = _lineStart;
+            _lineLength = 0;
+            _lineStart = _offset + 1;
+            StartLayout(count);
+            return;
+        }
+    }
+    _lineLength = 0;
+    _lineStart = _offset + 1;
+}
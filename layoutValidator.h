@@ -0,0 +1,95 @@
+// Title: Lab 6 - layoutValidator.h
+//
+// Purpose: Declares the LayoutValidator class which checks a stream of ship
+//          layouts in the text format read by Grid::LoadShips (layouts back
+//          to back) without holding the stream in memory.  The stream is
+//          fed in chunks of any size; every bad layout is reported with the
+//          byte offset where it starts.  The good layouts can be handed
+//          on to a LayoutSink as they are read.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_LAYOUTVALIDATOR_H
+#define BATTLESHIP_LAYOUTVALIDATOR_H
+
+#include <cstddef>
+#include <ostream>
+#include "boardMask.h"
+
+// Problems a layout can have
+enum LayoutError { LAYOUT_OK, LAYOUT_SYNTAX, LAYOUT_TOO_MANY, LAYOUT_BAD_SIZE,
+                   LAYOUT_OFF_GRID, LAYOUT_OVERLAP, LAYOUT_TRUNCATED };
+
+// Longest line kept while looking for the start of the next layout
+const int RESYNC_LINE_MAX = 32;
+
+//  Interface of the receiver of the good layouts a LayoutValidator reads
+class LayoutSink {
+public:
+    virtual ~LayoutSink() {}
+
+    virtual void Layout(const Ship ships[], int shipCount) = 0;
+};
+
+//  Class checking a stream of layouts
+//      Layouts are parsed one character at a time by a small state machine,
+//      so a chunk may end anywhere.  Each ship is checked against the grid
+//      and the ships before it with BoardMask operations.  After a syntax
+//      error, lines are skipped until one holding a lone count.
+class LayoutValidator {
+public:
+    LayoutValidator(ostream& report, LayoutSink* sink = nullptr);
+
+    void Feed(const char* data, size_t length);
+    void Finish();
+
+    long GetLayouts() const;
+    long GetBadLayouts() const;
+    unsigned long long GetBytes() const;
+
+private:
+    enum State { EXPECT_COUNT, EXPECT_NAME, IN_NAME, EXPECT_FIELD, IN_NUMBER, RESYNC };
+
+    void StartLayout(int count);
+    void EndNumber();
+    void CheckShip();
+    void EndLayout();
+    void Fail(LayoutError error);
+    void ResyncLine();
+
+    ostream& _report;
+    LayoutSink* _sink;
+
+    // Position in the stream
+    unsigned long long _offset;
+    State _state;
+    State _afterNumber;
+
+    // Number being read
+    long _value;
+    bool _negative;
+    bool _hasDigits;
+
+    // Layout being read
+    unsigned long long _layoutStart;
+    int _count;
+    int _ship;
+    int _field;
+    int _fields[4];
+    BoardMask _occupied;
+    Ship _ships[SHIPS_MAX];     // the ships read so far, names left empty
+    LayoutError _error;
+    int _errorShip;
+
+    // Line being read while resyncing
+    char _line[RESYNC_LINE_MAX];
+    int _lineLength;
+    unsigned long long _lineStart;
+
+    // Totals
+    long _layouts;
+    long _badLayouts;
+};
+
+#endif //BATTLESHIP_LAYOUTVALIDATOR_H
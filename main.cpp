@@ -4,12 +4,384 @@
 //          grids (by reading a file or randomly) and then displaying the game board and
 //          allowing the user to start playing
 //
+//          Usage:
+//              Battleship [-book bookFile] [-record logFile]
+//              Battleship -replay logFile [millisecondsPerShot [startShot]]
+//
+//          With -record the game is streamed to a replay log.  With -replay
+//          a logged game is played back instead, one shot every
+//          millisecondsPerShot (0 to fast-forward), starting from shot
+//          startShot.  When playback ends another shot can be jumped to.
+//          The CPU takes its first shots from the opening book bookFile,
+//          or from classic.book if there is one, when the book was built
+//          for the roster of the user's ships (see BuildBook).
+//
 // Class: CSC 2430 Winter 2020
 // Author: <your name>
 
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
+#include <cctype>
 #include <assert.h>
 #include "gameBoard.h"
 #include "cpulogic.h"
+#include "speculativeStrategy.h"
+#include "replayLog.h"
+
+// Delay between shots of a replay unless given on the command line
+const int REPLAY_DELAY_DEFAULT = 500;
+
+//  Return the name of a square as shown on the grid, e.g. "B7"
+//  Parameters:
+//      row - row of the square
+//      column - column of the square
+//  Returns:
+//      the name
+//  Possible Errors:
+//      none
+string SquareName(int row, int column) {
+    ostringstream name;
+
+    name << (char)('A' + column) << row;
+    return name.str();
+}
+
+//  Convert the name of a square typed by the user to its row and column
+//  Parameters:
+//      text - what the user typed, a column letter then a row digit
+//      row - receives the row
+//      column - receives the column
+//  Returns:
+//      true if text names a square of the grid
+//  Possible Errors:
+//      none
+bool ParseSquare(const string& text, int& row, int& column) {
+    istringstream input(text);
+    string word;
+    char letter;
+
+    if (!(input >> word) || 2 != word.size()) {
+        return false;
+    }
+    letter = (char)toupper(word[0]);
+    if (letter < 'A' || letter >= 'A' + COUNT_COLUMNS || word[1] < '0' || word[1] >= '0' + COUNT_ROWS) {
+        return false;
+    }
+    column = letter - 'A';
+    row = word[1] - '0';
+    return !(input >> word);
+}
+
+//  Describe the outcome of a shot
+//  Parameters:
+//      outcome - outcome of the shot
+//  Returns:
+//      text completing "... fired at B7 and"
+//  Possible Errors:
+//      none
+string OutcomeText(Outcome outcome) {
+    switch (outcome) {
+        case SHOT_MISSED:
+            return "missed";
+        case SHIP_HIT:
+            return "hit a ship";
+        case SHIP_SUNK:
+            return "sank a ship";
+        case GAME_WON:
+            return "won the game";
+        case SHOT_HERE_BEFORE:
+            return "had fired there before";
+    }
+    return "";
+}
+
+//  Ask for the random seed until a number is entered
+//  Parameters:
+//      none
+//  Returns:
+//      the seed
+//  Possible Errors:
+//      none
+uint64_t AskSeed() {
+    string line;
+    uint64_t seed;
+
+    while (true) {
+        cout << "Enter random seed: ";
+        if (!getline(cin, line)) {
+            exit(1);
+        }
+        istringstream input(line);
+        if (input >> seed) {
+            return seed;
+        }
+        cout << "The seed must be a number" << endl;
+    }
+}
+
+//  Ask how to place the ships of a grid, and place them from a file or
+//      randomly, asking again if the file cannot be loaded
+//  Parameters:
+//      game - the game board
+//      forUser - true for the user's grid, false for the CPU's
+//      rng - random number generator for random placement
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ConfigureGrid(GameBoard& game, bool forUser, Rng& rng) {
+    string fileName;
+
+    while (true) {
+        cout << "Enter file name of the " << (forUser ? "user's" : "CPU's")
+             << " ships (or ENTER for random placement): ";
+        if (!getline(cin, fileName)) {
+            exit(1);
+        }
+        if (fileName.empty()) {
+            game.RandomlyPlaceShips(forUser, rng);
+            return;
+        }
+        if (game.LoadShipsFromFile(forUser, fileName)) {
+            return;
+        }
+        cout << "Cannot load ships from " << fileName << endl;
+    }
+}
+
+//  Collect the roster of the ships placed on a grid
+//  Parameters:
+//      grid - the grid
+//      ships - receives the ships
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void GetRoster(const Grid& grid, vector<Ship>& ships) {
+    ships.resize(grid.GetShipsDeployed());
+    for (int i = 0; i < grid.GetShipsDeployed(); i ++) {
+        grid.GetShip(i, ships[i]);
+    }
+}
+
+//  Open the opening book for the roster of a grid's ships
+//  Parameters:
+//      book - the book to open
+//      fileName - name of the book file
+//      ships - the roster
+//      quiet - true to say nothing when the book cannot be used
+//  Returns:
+//      true if the book is open and for the roster
+//  Possible Errors:
+//      file cannot be read, book for another roster
+bool OpenBook(OpeningBook& book, const string& fileName, const vector<Ship>& ships, bool quiet) {
+    if (!book.Open(fileName)) {
+        if (!quiet) {
+            cerr << "Cannot read opening book " << fileName << endl;
+        }
+        return false;
+    }
+    if (!book.Matches(ships.data(), (int)ships.size())) {
+        if (!quiet) {
+            cerr << "The opening book " << fileName << " is for other ships" << endl;
+        }
+        book.Close();
+        return false;
+    }
+    return true;
+}
+
+//  Play a game, the user firing first and the CPU answering, until one of
+//      them wins
+//  Parameters:
+//      logFileName - replay log to stream the game to, or empty for none
+//      bookFileName - opening book for the CPU, or empty for the default
+//  Returns:
+//      exit code of the program
+//  Possible Errors:
+//      the replay log cannot be created, the opening book cannot be used,
+//      or the display cannot be shown
+int PlayGame(const string& logFileName, const string& bookFileName) {
+    GameBoard game;
+    vector<Ship> ships;
+    OpeningBook book;
+    ReplayWriter log;
+    uint64_t seed;
+    Rng rng;
+    Rng cpuRng;
+    bool over;
+
+    // The CPU's shots have their own stream, independent of the placement
+    seed = AskSeed();
+    rng.Seed(seed);
+    cpuRng = rng.Split();
+    ConfigureGrid(game, true, rng);
+    ConfigureGrid(game, false, rng);
+    GetRoster(game.GetGrid(true), ships);
+    if (bookFileName.empty()) {
+        OpenBook(book, OPENING_BOOK_DEFAULT, ships, true);
+    }
+    else if (!OpenBook(book, bookFileName, ships, false)) {
+        return 1;
+    }
+    if (!logFileName.empty() && !log.Open(logFileName, seed, game.GetGrid(true), game.GetGrid(false))) {
+        cerr << "Cannot create replay log " << logFileName << endl;
+        return 1;
+    }
+    if (!game.ShowInitialDisplay()) {
+        return 1;
+    }
+
+    // The CPU hunts for the user's ships, whatever they are
+    CpuLogic cpuLogic(true, ships.data(), (int)ships.size());
+    SpeculativeStrategy cpu(cpuLogic, cpuRng);
+
+    cpuLogic.UseBook(&book);
+    cpu.Init();
+    over = false;
+    while (!over) {
+        ostringstream response;
+        Outcome outcome;
+        int row;
+        int column;
+
+        // The user's shot
+        game.WritePrompt("Enter the square to fire at (e.g. B7)");
+        while (!ParseSquare(game.GetLine(), row, column)) {
+            game.WriteResponse("A square is a column letter A-J followed by a row number 0-9", RED_INVERSE);
+        }
+        game.FireShot(false, row, column, outcome);
+        log.RecordShot(row, column, outcome);
+        response << "You fired at " << SquareName(row, column) << " and " << OutcomeText(outcome) << ".";
+        over = GAME_WON == outcome;
+
+        // The CPU's answer
+        if (!over) {
+            cpu.DetermineShot(row, column, cpuRng);
+            game.FireShot(true, row, column, outcome);
+            cpu.ReportOutcome(row, column, outcome);
+            log.RecordShot(row, column, outcome);
+            response << "  CPU fired at " << SquareName(row, column) << " and " << OutcomeText(outcome) << ".";
+            over = GAME_WON == outcome;
+        }
+        game.WriteResponse(response.str());
+    }
+    log.Close();
+    game.WritePrompt("Game over, press ENTER to exit");
+    game.GetLine();
+    return 0;
+}
+
+//  Play back the shots of a replay log from one shot to the end
+//  Parameters:
+//      game - the game board, showing the grids before shot first
+//      log - the replay log
+//      first - number of the first shot to play
+//      delay - milliseconds to wait before each shot
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void PlayShots(GameBoard& game, const ReplayLog& log, long first, int delay) {
+    for (long i = first; i < log.GetShotCount(); i ++) {
+        ostringstream response;
+        bool atUser;
+        int row;
+        int column;
+        Outcome outcome;
+
+        if (delay > 0) {
+            napms(delay);
+        }
+        log.GetShot(i, atUser, row, column);
+        game.FireShot(atUser, row, column, outcome);
+        response << "Shot " << i + 1 << " of " << log.GetShotCount() << ": "
+                 << (atUser ? "CPU" : "User") << " fired at " << SquareName(row, column)
+                 << " and " << OutcomeText(outcome) << ".";
+        game.WriteResponse(response.str());
+    }
+}
+
+//  Play back a replay log.  When playback ends the user may enter a shot
+//      number to jump to and play back from there
+//  Parameters:
+//      logFileName - the replay log
+//      delay - milliseconds between shots
+//      first - number of shots to skip before playback starts
+//  Returns:
+//      exit code of the program
+//  Possible Errors:
+//      the log cannot be read or the display cannot be shown
+int ReplayGame(const string& logFileName, int delay, long first) {
+    GameBoard game;
+    ReplayLog log;
+    Grid user;
+    Grid cpu;
+
+    if (!log.Load(logFileName)) {
+        cerr << "Cannot read replay log " << logFileName << endl;
+        return 1;
+    }
+    if (first < 0 || first > log.GetShotCount()) {
+        cerr << "The log has " << log.GetShotCount() << " shots" << endl;
+        return 1;
+    }
+    log.Seek(first, user, cpu);
+    if (!game.SetGrid(true, user) || !game.SetGrid(false, cpu)) {
+        cerr << "The log is not of a " << COUNT_ROWS << "x" << COUNT_COLUMNS << " game" << endl;
+        return 1;
+    }
+    if (!game.ShowInitialDisplay()) {
+        return 1;
+    }
+
+    while (true) {
+        ostringstream prompt;
+        string line;
+
+        PlayShots(game, log, first, delay);
+        prompt << "Enter a shot number (0-" << log.GetShotCount() << ") to replay from, or ENTER to exit";
+        game.WritePrompt(prompt.str());
+        line = game.GetLine();
+        if (line.empty()) {
+            return 0;
+        }
+        istringstream input(line);
+        if (!(input >> first) || first < 0 || first > log.GetShotCount()) {
+            game.WriteResponse("Not a shot number", RED_INVERSE);
+            first = log.GetShotCount();
+            continue;
+        }
+        log.Seek(first, user, cpu);
+        game.SetGrid(true, user);
+        game.SetGrid(false, cpu);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string bookFileName;
+    string option;
+    int first;
 
+    // The book comes first, then the rest as without it
+    first = 1;
+    if (argc > 2 && string(argv[1]) == "-book") {
+        bookFileName = argv[2];
+        first = 3;
+    }
+    option = argc > first ? argv[first] : "";
+    if (first == argc) {
+        return PlayGame("", bookFileName);
+    }
+    if ("-record" == option && first + 2 == argc) {
+        return PlayGame(argv[first + 1], bookFileName);
+    }
+    if ("-replay" == option && 1 == first && argc >= 3 && argc <= 5) {
+        return ReplayGame(argv[2], argc > 3 ? atoi(argv[3]) : REPLAY_DELAY_DEFAULT,
+                          argc > 4 ? atol(argv[4]) : 0);
+    }
+    cerr << "Usage: " << argv[0] << " [-book bookFile] [-record logFile]" << endl;
+    cerr << "       " << argv[0] << " -replay logFile [millisecondsPerShot [startShot]]" << endl;
+    return 1;
+}
@@ -0,0 +1,356 @@
+// Title: Lab 6 - openingBook.cpp
+//
+// Purpose: Implements the classes that build and read the opening book
+//          declared in openingBook.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "openingBook.h"
+
+//  Put the sizes of a roster in a header, longest first
+//  Parameters:
+//      ships - roster of ships, only sizes are used
+//      shipCount - number of elements in ships (<= BOOK_SHIPS_MAX)
+//      sizes - receives the sizes
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+static void SortSizes(const Ship ships[], int shipCount, uint8_t sizes[]) {
+    memset(sizes, 0, BOOK_SHIPS_MAX);
+    for (int i = 0; i < shipCount; i ++) {
+        sizes[i] = (uint8_t)ships[i].size;
+    }
+    sort(sizes, sizes + shipCount, greater<uint8_t>());
+}
+
+//
+//  Constructor
+OpeningBook::OpeningBook() {
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _nodes = nullptr;
+}
+
+//
+//  Destructor
+//      Unmaps the file
+OpeningBook::~OpeningBook() {
+    Close();
+}
+
+//  Map a book into memory and check it.  Every node is checked here so
+//      that following the book needs no checks
+//  Parameters:
+//      fileName - name of the file
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be opened or mapped, wrong magic or version, built for
+//      another grid size, truncated, or a node out of range
+bool OpeningBook::Open(const string& fileName) {
+    int fd;
+    struct stat info;
+    void* data;
+
+    Close();
+    fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(BookHeader)) {
+        close(fd);
+        return false;
+    }
+    data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data) {
+        return false;
+    }
+    _data = (const unsigned char*)data;
+    _size = info.st_size;
+    _header = (const BookHeader*)_data;
+    _nodes = (const BookNode*)(_data + sizeof(BookHeader));
+
+    if (memcmp(_header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0
+        || _header->version != BOOK_VERSION
+        || _header->rows != COUNT_ROWS || _header->columns != COUNT_COLUMNS
+        || _header->shipCount > BOOK_SHIPS_MAX || _header->nodeCount < 1
+        || _header->nodeCount > (_size - sizeof(BookHeader)) / sizeof(BookNode)) {
+        Close();
+        return false;
+    }
+    for (int i = 0; i < _header->nodeCount; i ++) {
+        bool valid = _nodes[i].square < COUNT_SQUARES;
+
+        for (int j = 0; j < BOOK_OUTCOMES; j ++) {
+            valid = valid && _nodes[i].next[j] < _header->nodeCount;
+        }
+        if (!valid) {
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Unmap the file, if one is open
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void OpeningBook::Close() {
+    if (_data) {
+        munmap((void*)_data, _size);
+    }
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _nodes = nullptr;
+}
+
+//  Return whether a book is open
+bool OpeningBook::IsOpen() const {
+    return _header != nullptr;
+}
+
+//  Return whether the book was built for a roster.  Only the sizes of the
+//      ships count, in any order
+//  Parameters:
+//      ships - roster of ships
+//      shipCount - number of elements in ships
+//  Returns:
+//      true if a book is open and its roster has the same sizes
+//  Possible Errors:
+//      none
+bool OpeningBook::Matches(const Ship ships[], int shipCount) const {
+    uint8_t sizes[BOOK_SHIPS_MAX];
+
+    if (!_header || shipCount != _header->shipCount) {
+        return false;
+    }
+    SortSizes(ships, shipCount, sizes);
+    return 0 == memcmp(sizes, _header->sizes, BOOK_SHIPS_MAX);
+}
+
+//  Return the square a node fires at
+//  Parameters:
+//      node - node number, 0 for the first shot
+//  Returns:
+//      the square, row*COUNT_COLUMNS + column
+//  Possible Errors:
+//      none expected
+int OpeningBook::GetSquare(int node) const {
+    return _nodes[node].square;
+}
+
+//  Return the node to go to after the shot of a node
+//  Parameters:
+//      node - node number
+//      outcome - outcome of the node's shot
+//  Returns:
+//      the next node, or -1 if the book ends there
+//  Possible Errors:
+//      none
+int OpeningBook::GetNext(int node, Outcome outcome) const {
+    uint16_t next;
+
+    switch (outcome) {
+        case SHOT_MISSED:
+            next = _nodes[node].next[BOOK_MISS];
+            break;
+        case SHIP_HIT:
+            next = _nodes[node].next[BOOK_HIT];
+            break;
+        case SHIP_SUNK:
+            next = _nodes[node].next[BOOK_SUNK];
+            break;
+        default:
+            next = BOOK_NONE;
+            break;
+    }
+    return BOOK_NONE == next ? -1 : next;
+}
+
+//
+//  Constructor
+OpeningBookBuilder::OpeningBookBuilder() {
+    memset(&_header, 0, sizeof(_header));
+}
+
+//  Build a book for a roster
+//  Parameters:
+//      ships - roster of ships, only sizes are used
+//      shipCount - number of elements in ships
+//      rng - random number generator to lay out the ships with
+//      depth - most shots on a path through the book
+//      samples - number of random layouts to start from
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      no ships or more than BOOK_SHIPS_MAX, depth or samples out of
+//      range, or the ships do not fit on the grid
+bool OpeningBookBuilder::Build(const Ship ships[], int shipCount, Rng& rng, int depth, long samples) {
+    vector<long> layouts;
+
+    _nodes.clear();
+    _ships.clear();
+    if (shipCount < 1 || shipCount > BOOK_SHIPS_MAX || depth < 1 || depth > COUNT_SQUARES
+        || samples < 1) {
+        return false;
+    }
+    memset(&_header, 0, sizeof(_header));
+    memcpy(_header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    _header.version = BOOK_VERSION;
+    _header.rows = COUNT_ROWS;
+    _header.columns = COUNT_COLUMNS;
+    _header.depth = (uint8_t)depth;
+    _header.shipCount = (uint8_t)shipCount;
+    SortSizes(ships, shipCount, _header.sizes);
+
+    // Lay out the ships at random, keeping each ship as a mask
+    _ships.reserve(samples*shipCount);
+    layouts.reserve(samples);
+    for (long i = 0; i < samples; i ++) {
+        Grid grid(COUNT_ROWS, COUNT_COLUMNS, shipCount);
+
+        grid.RandomlyPlaceShips(ships, shipCount, rng);
+        if (grid.GetShipsDeployed() != shipCount) {
+            _ships.clear();
+            return false;
+        }
+        for (int j = 0; j < shipCount; j ++) {
+            Ship ship;
+            BoardMask mask;
+            int square;
+
+            grid.GetShip(j, ship);
+            mask = 0;
+            square = ship.startRow*COUNT_COLUMNS + ship.startColumn;
+            for (int k = 0; k < ship.size; k ++, square += ship.isVertical ? COUNT_COLUMNS : 1) {
+                mask |= (BoardMask)1 << square;
+            }
+            _ships.push_back(mask);
+        }
+        layouts.push_back(i);
+    }
+
+    Expand(layouts, 0, 0, 0);
+    _header.nodeCount = (uint16_t)_nodes.size();
+    _ships.clear();
+    _ships.shrink_to_fit();
+    return true;
+}
+
+//  Return the number of nodes of the book built
+int OpeningBookBuilder::GetNodeCount() const {
+    return (int)_nodes.size();
+}
+
+//  Write the book built to a file
+//  Parameters:
+//      fileName - name of the file
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      nothing built, file cannot be created or written
+bool OpeningBookBuilder::Save(const string& fileName) const {
+    ofstream file;
+
+    if (_nodes.empty()) {
+        return false;
+    }
+    file.open(fileName, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write((const char*)&_header, sizeof(_header));
+    file.write((const char*)_nodes.data(), _nodes.size()*sizeof(BookNode));
+    file.close();
+    return !file.fail();
+}
+
+//  Add the node for a history of shots, and below it the nodes for the
+//      outcomes of its shot that enough of the layouts lead to
+//  Parameters:
+//      layouts - the layouts agreeing with the history, emptied
+//      shot - squares fired at so far
+//      hits - the squares of shot that hit a ship
+//      depth - number of shots fired so far
+//  Returns:
+//      number of the node
+//  Possible Errors:
+//      none
+uint16_t OpeningBookBuilder::Expand(vector<long>& layouts, BoardMask shot, BoardMask hits, int depth) {
+    int shipCount = _header.shipCount;
+    long counts[COUNT_SQUARES];
+    vector<long> split[BOOK_OUTCOMES];
+    uint16_t node;
+    BoardMask square;
+    int best;
+
+    // Fire where the most layouts have a ship, the first such square on ties
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        counts[s] = 0;
+    }
+    for (long layout : layouts) {
+        BoardMask unshot = 0;
+
+        for (int j = 0; j < shipCount; j ++) {
+            unshot |= _ships[layout*shipCount + j];
+        }
+        unshot &= ~shot;
+        while (unshot != 0) {
+            counts[SelectBit(unshot, 0)] ++;
+            unshot &= unshot - 1;
+        }
+    }
+    best = -1;
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        if ((shot & (BoardMask)1 << s) == 0 && (best < 0 || counts[s] > counts[best])) {
+            best = s;
+        }
+    }
+    node = (uint16_t)_nodes.size();
+    _nodes.push_back(BookNode { (uint8_t)best, 0, { BOOK_NONE, BOOK_NONE, BOOK_NONE } });
+    if (depth + 1 >= _header.depth) {
+        return node;
+    }
+
+    // Split the layouts by the outcome of the shot
+    square = (BoardMask)1 << best;
+    for (long layout : layouts) {
+        int outcome = BOOK_MISS;
+
+        for (int j = 0; j < shipCount; j ++) {
+            BoardMask ship = _ships[layout*shipCount + j];
+
+            if ((ship & square) != 0) {
+                outcome = (ship & ~(hits | square)) == 0 ? BOOK_SUNK : BOOK_HIT;
+                break;
+            }
+        }
+        split[outcome].push_back(layout);
+    }
+    vector<long>().swap(layouts);
+    for (int outcome = 0; outcome < BOOK_OUTCOMES; outcome ++) {
+        if ((long)split[outcome].size() >= BOOK_SAMPLES_MIN && _nodes.size() < BOOK_NODES_MAX) {
+            uint16_t next;
+
+            next = Expand(split[outcome], shot | square, BOOK_MISS == outcome ? hits : hits | square, depth + 1);
+            _nodes[node].next[outcome] = next;
+        }
+    }
+    return node;
+}
@@ -0,0 +1,128 @@
+// Title: Lab 6 - openingBook.h
+//
+// Purpose: Declares the opening book, a precomputed table of the CPU's
+//          first shots for one roster of ships, and the classes that
+//          build it and read it.
+//
+//          The book is a tree.  Each node holds the square to fire at
+//          next and, per outcome of that shot (miss, hit, sunk), the node
+//          to go to after it.  The root holds the first shot, so the
+//          history of outcomes alone picks the node.  A book file is a
+//          fixed size header, naming the grid size and the roster, and
+//          then the nodes.  It is memory-mapped and read in place.
+//
+//          Multi-byte fields are stored little-endian.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_OPENINGBOOK_H
+#define BATTLESHIP_OPENINGBOOK_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "boardMask.h"
+
+// Format identification
+const char BOOK_MAGIC[4] = { 'B', 'S', 'O', 'B' };
+const uint16_t BOOK_VERSION = 1;
+
+// Most ships a roster of a book may have
+const int BOOK_SHIPS_MAX = 16;
+
+// Most nodes a book may have, node numbers must fit in a uint16_t
+const int BOOK_NODES_MAX = 65535;
+
+// Next node of a node for an outcome that leaves the book
+const uint16_t BOOK_NONE = 0;
+
+// Defaults for building a book: shots deep, random layouts to start
+// from, and layouts a node must still agree with to be expanded
+const int BOOK_DEPTH_DEFAULT = 12;
+const long BOOK_SAMPLES_DEFAULT = 200000;
+const long BOOK_SAMPLES_MIN = 1000;
+
+// The book the game loads at startup unless another is given
+const char OPENING_BOOK_DEFAULT[] = "classic.book";
+
+static_assert(COUNT_SQUARES <= 256, "a square must fit in a byte");
+
+// Outcomes a node has a next node for
+enum BookOutcome { BOOK_MISS, BOOK_HIT, BOOK_SUNK, BOOK_OUTCOMES };
+
+// Header at the start of a book file
+//      magic - BOOK_MAGIC
+//      version - BOOK_VERSION
+//      rows, columns - grid the book was built for
+//      depth - most shots on a path through the book
+//      shipCount - number of entries used in sizes
+//      nodeCount - number of nodes following the header, node 0 is the root
+//      reserved - zero
+//      sizes - sizes of the ships of the roster, longest first
+struct BookHeader {
+    char magic[4];
+    uint16_t version;
+    uint8_t rows;
+    uint8_t columns;
+    uint8_t depth;
+    uint8_t shipCount;
+    uint16_t nodeCount;
+    uint32_t reserved;
+    uint8_t sizes[BOOK_SHIPS_MAX];
+};
+
+// A node of the book
+//      square - square to fire at, row*columns + column
+//      reserved - zero
+//      next - per BookOutcome the node to go to, or BOOK_NONE
+struct BookNode {
+    uint8_t square;
+    uint8_t reserved;
+    uint16_t next[BOOK_OUTCOMES];
+};
+
+//  Read-only, memory-mapped opening book
+class OpeningBook {
+public:
+    OpeningBook();
+    ~OpeningBook();
+
+    bool Open(const string& fileName);
+    void Close();
+    bool IsOpen() const;
+
+    bool Matches(const Ship ships[], int shipCount) const;
+    int GetSquare(int node) const;
+    int GetNext(int node, Outcome outcome) const;
+
+private:
+    const unsigned char* _data;
+    size_t _size;
+    const BookHeader* _header;
+    const BookNode* _nodes;
+};
+
+//  Builds an opening book.  Random layouts of the roster stand in for the
+//      opponent's: each node fires at the square that the most of the
+//      layouts agreeing with its history have a ship on, and its shot
+//      splits those layouts among the next nodes by outcome
+class OpeningBookBuilder {
+public:
+    OpeningBookBuilder();
+
+    bool Build(const Ship ships[], int shipCount, Rng& rng,
+               int depth = BOOK_DEPTH_DEFAULT, long samples = BOOK_SAMPLES_DEFAULT);
+    int GetNodeCount() const;
+    bool Save(const string& fileName) const;
+
+private:
+    uint16_t Expand(vector<long>& layouts, BoardMask shot, BoardMask hits, int depth);
+
+    BookHeader _header;
+    vector<BookNode> _nodes;
+    vector<BoardMask> _ships;   // the ships of each layout, shipCount apiece
+};
+
+#endif //BATTLESHIP_OPENINGBOOK_H
@@ -0,0 +1,197 @@
+// Title: Lab 6 - placementBench.cpp
+//
+// Purpose: Check every version of the placement count kernel against a
+//          naive reference on random boards, then time each version.
+//          Also compare boards/second of random ship placement by sampling
+//          the legal starts (Grid::RandomlyPlaceShips) against trying random
+//          positions until they fit.
+//
+//          Usage: PlacementBench [iterations]
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "placementKernel.h"
+#include "grid.h"
+
+using namespace std;
+
+const long DEFAULT_ITERATIONS = 1000000;
+const int BOARDS = 64;
+const int LENGTH_MAX = COUNT_ROWS > COUNT_COLUMNS ? COUNT_ROWS : COUNT_COLUMNS;
+
+//  Naive reference: try every placement and count the squares it covers
+void CountPlacementsReference(const uint16_t freeRows[COUNT_ROWS], int length,
+                              uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]) {
+    for (int vertical = 0; vertical < 2; vertical ++) {
+        for (int r = 0; r < COUNT_ROWS; r ++) {
+            for (int c = 0; c < COUNT_COLUMNS; c ++) {
+                bool fits = true;
+
+                for (int k = 0; k < length && fits; k ++) {
+                    int rr = vertical ? r + k : r;
+                    int cc = vertical ? c : c + k;
+
+                    fits = rr < COUNT_ROWS && cc < COUNT_COLUMNS && ((freeRows[rr] >> cc) & 1);
+                }
+                for (int k = 0; k < length && fits; k ++) {
+                    int rr = vertical ? r + k : r;
+                    int cc = vertical ? c : c + k;
+
+                    counts[rr*ROW_LANES + cc] += weight;
+                }
+            }
+        }
+    }
+}
+
+//  Make a board with roughly a third of its squares blocked
+void RandomBoard(Rng& rng, uint16_t freeRows[COUNT_ROWS]) {
+    for (int r = 0; r < COUNT_ROWS; r ++) {
+        freeRows[r] = (uint16_t)(rng.Next() | rng.Next());
+    }
+}
+
+//  Compare a kernel against the reference for every length on many boards
+bool Check(const char* name, PlacementCountKernel kernel) {
+    Rng rng(12345);
+
+    for (int i = 0; i < 1000; i ++) {
+        uint16_t freeRows[COUNT_ROWS];
+        uint16_t expected[COUNT_ROWS*ROW_LANES];
+        uint16_t actual[COUNT_ROWS*ROW_LANES];
+
+        RandomBoard(rng, freeRows);
+        if (i == 0) {
+            memset(freeRows, 0xFF, sizeof(freeRows));
+        }
+        for (int len = 1; len <= LENGTH_MAX; len ++) {
+            uint16_t weight = (uint16_t)(1 + rng.Below(7));
+
+            for (int j = 0; j < COUNT_ROWS*ROW_LANES; j ++) {
+                expected[j] = actual[j] = (uint16_t)rng.Below(100);
+            }
+            CountPlacementsReference(freeRows, len, weight, expected);
+            kernel(freeRows, len, weight, actual);
+            if (memcmp(expected, actual, sizeof(actual)) != 0) {
+                cout << name << ": MISMATCH on board " << i << " length " << len << endl;
+                return false;
+            }
+        }
+    }
+    cout << name << ": matches reference" << endl;
+    return true;
+}
+
+//  Time a kernel counting the classic roster on a set of boards
+void Time(const char* name, PlacementCountKernel kernel, long iterations) {
+    const int lengths[] = { 5, 4, 3, 3, 2 };
+    uint16_t boards[BOARDS][COUNT_ROWS];
+    uint16_t counts[COUNT_ROWS*ROW_LANES];
+    Rng rng(1);
+    unsigned sink = 0;
+
+    for (int b = 0; b < BOARDS; b ++) {
+        RandomBoard(rng, boards[b]);
+    }
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i ++) {
+        memset(counts, 0, sizeof(counts));
+        for (int s = 0; s < 5; s ++) {
+            kernel(boards[i % BOARDS], lengths[s], 1, counts);
+        }
+        sink += counts[i % (COUNT_ROWS*ROW_LANES)];
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+
+    cout << setw(8) << name << " " << fixed << setprecision(1)
+         << elapsed.count() / iterations << " ns/board (5 ships)"
+         << "  [" << sink % 10 << "]" << endl;
+}
+
+//  Place ships the old way: pick a random orientation and position and
+//      retry until AddShip accepts it.  Starts over if a ship seems not to
+//      fit, where the old code would loop forever
+void RetryPlaceShips(Grid& grid, const Ship ships[], int shipCount, Rng& rng) {
+    grid.Init();
+    for (int i = 0; i < shipCount; i ++) {
+        bool placed = false;
+
+        for (int tries = 0; !placed; tries ++) {
+            if (tries == 1000) {
+                grid.Init();
+                i = 0;
+                tries = 0;
+            }
+            bool isVertical = rng.Below(2) == 1;
+            int startRow = rng.Below(isVertical ? COUNT_ROWS - ships[i].size + 1 : COUNT_ROWS);
+            int startColumn = rng.Below(isVertical ? COUNT_COLUMNS : COUNT_COLUMNS - ships[i].size + 1);
+
+            placed = grid.AddShip(ships[i].name, ships[i].size, isVertical, startRow, startColumn);
+        }
+    }
+}
+
+//  Time placing a roster of ships both ways
+void TimeShipPlacement(const char* name, const Ship ships[], int shipCount, long iterations) {
+    Grid grid;
+    Rng rng(1);
+    double retry;
+    double sampled;
+
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i ++) {
+        RetryPlaceShips(grid, ships, shipCount, rng);
+    }
+    retry = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i ++) {
+        grid.RandomlyPlaceShips(ships, shipCount, rng);
+    }
+    sampled = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << setw(8) << name << " retry " << fixed << setprecision(0) << iterations / retry
+         << " boards/s, sampled " << iterations / sampled << " boards/s" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations;
+    bool ok;
+
+    iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    cout << "Best kernel: " << BestPlacementKernelName() << endl;
+
+    ok = Check("scalar", CountPlacementsScalar);
+#if defined(__x86_64__) || defined(__i386__)
+    ok = Check("sse2", CountPlacementsSse2) && ok;
+    if (__builtin_cpu_supports("avx2")) {
+        ok = Check("avx2", CountPlacementsAvx2) && ok;
+    }
+#endif
+    if (!ok) {
+        return 1;
+    }
+
+    Time("scalar", CountPlacementsScalar, iterations);
+#if defined(__x86_64__) || defined(__i386__)
+    Time("sse2", CountPlacementsSse2, iterations);
+    if (__builtin_cpu_supports("avx2")) {
+        Time("avx2", CountPlacementsAvx2, iterations);
+    }
+#endif
+
+    // A crowded roster makes the retry loop work much harder
+    const Ship crowded[] = { { "Long", 7, false, 0, 0, 0 }, { "Long", 7, false, 0, 0, 0 },
+                             { "Long", 7, false, 0, 0, 0 }, { "Long", 7, false, 0, 0, 0 },
+                             { "Long", 7, false, 0, 0, 0 } };
+
+    TimeShipPlacement("classic", CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, iterations);
+    TimeShipPlacement("crowded", crowded, sizeof(crowded)/sizeof(crowded[0]), iterations);
+    return 0;
+}
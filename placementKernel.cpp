@@ -0,0 +1,271 @@
+// Title: Lab 6 - placementKernel.cpp
+//
+// Purpose: Implements the placement count kernel in scalar, SSE2 and AVX2
+//          versions, and picks the best one at run time.
+//
+//          All versions first find, with a few bit operations per row,
+//          the start squares where a ship fits horizontally (hStarts) and
+//          vertically (vStarts).  A square (r, c) is then covered by the
+//          horizontal starts in hStarts[r] << k and the vertical starts in
+//          vStarts[r-k], for k = 0..length-1.  The vector versions keep one
+//          16-bit lane per column and update a whole row at once.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include "placementKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Bits of a row that are on the grid
+const uint16_t ROW_MASK = (uint16_t)((1u << COUNT_COLUMNS) - 1);
+
+//  Find the start squares of every placement of a ship of a given length
+//  Parameters:
+//      freeRows - free squares of each row
+//      length - length of the ship
+//      hStarts - receives the squares where a horizontal placement starts
+//      vStarts - receives the squares where a vertical placement starts
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+static inline void FindStarts(const uint16_t freeRows[COUNT_ROWS], int length,
+                              uint16_t hStarts[COUNT_ROWS], uint16_t vStarts[COUNT_ROWS]) {
+    for (int r = 0; r < COUNT_ROWS; r ++) {
+        uint16_t row = freeRows[r] & ROW_MASK;
+        uint16_t h = length <= COUNT_COLUMNS ? row : 0;
+
+        for (int k = 1; k < length && h != 0; k ++) {
+            h &= row >> k;
+        }
+        hStarts[r] = h;
+    }
+    for (int r = 0; r < COUNT_ROWS; r ++) {
+        uint16_t v = r + length <= COUNT_ROWS ? (uint16_t)(freeRows[r] & ROW_MASK) : 0;
+
+        for (int k = 1; k < length && v != 0; k ++) {
+            v &= freeRows[r+k];
+        }
+        vStarts[r] = v;
+    }
+}
+
+//  Scalar version of the kernel, see placementKernel.h
+//      A square is covered horizontally by a running sum of the starts in
+//      the last length columns, and vertically by a running sum of the
+//      starts in the last length rows
+void CountPlacementsScalar(const uint16_t freeRows[COUNT_ROWS], int length,
+                           uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]) {
+    uint16_t hStarts[COUNT_ROWS];
+    uint16_t vStarts[COUNT_ROWS];
+    uint16_t vSum[COUNT_COLUMNS];
+
+    FindStarts(freeRows, length, hStarts, vStarts);
+    for (int c = 0; c < COUNT_COLUMNS; c ++) {
+        vSum[c] = 0;
+    }
+    for (int r = 0; r < COUNT_ROWS; r ++) {
+        uint16_t* row = counts + r*ROW_LANES;
+        unsigned entering = vStarts[r];
+        unsigned leaving = r >= length ? vStarts[r-length] : 0;
+        int hSum = 0;
+
+        for (int c = 0; c < COUNT_COLUMNS; c ++) {
+            hSum += ((hStarts[r] >> c) & 1) - (c >= length ? (hStarts[r] >> (c - length)) & 1 : 0);
+            vSum[c] += ((entering >> c) & 1) - ((leaving >> c) & 1);
+            row[c] += (uint16_t)(weight*(hSum + vSum[c]));
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+//  Build the horizontal window of each column: lane c holds the bits of the
+//      start columns whose horizontal placement covers column c
+//  Parameters:
+//      length - length of the ship
+//      window - receives one mask per lane, zero past COUNT_COLUMNS
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+static inline void HorizontalWindows(int length, uint16_t window[ROW_LANES]) {
+    for (int c = 0; c < ROW_LANES; c ++) {
+        int low = c + 1 > length ? c + 1 - length : 0;
+
+        window[c] = c < COUNT_COLUMNS ? (uint16_t)(((2u << c) - 1) & ~((1u << low) - 1)) : 0;
+    }
+}
+
+//  Count the bits of each 16-bit lane
+__attribute__((target("sse2")))
+static inline __m128i Popcount16(__m128i x) {
+    x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1), _mm_set1_epi16(0x5555)));
+    x = _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)),
+                      _mm_and_si128(_mm_srli_epi16(x, 2), _mm_set1_epi16(0x3333)));
+    x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)), _mm_set1_epi16(0x0F0F));
+    return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), _mm_set1_epi16(0x1F));
+}
+
+//  Count the bits of each 16-bit lane
+__attribute__((target("avx2")))
+static inline __m256i Popcount16(__m256i x) {
+    const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i bytes;
+
+    bytes = _mm256_add_epi8(_mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(x, lowNibbles)),
+                            _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi16(x, 4), lowNibbles)));
+    return _mm256_and_si256(_mm256_add_epi16(bytes, _mm256_srli_epi16(bytes, 8)), _mm256_set1_epi16(0xFF));
+}
+
+//  SSE2 version of the kernel, see placementKernel.h
+//      Each row of counters is two registers of eight lanes.  The horizontal
+//      count of a square is the popcount of the row's starts within the
+//      square's window; the vertical count is a running sum of the starts
+//      of the last length rows, one lane per column.
+__attribute__((target("sse2")))
+void CountPlacementsSse2(const uint16_t freeRows[COUNT_ROWS], int length,
+                         uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]) {
+    uint16_t hStarts[COUNT_ROWS];
+    uint16_t vStarts[COUNT_ROWS];
+    uint16_t window[ROW_LANES];
+    const __m128i bitsLow = _mm_setr_epi16(0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80);
+    const __m128i bitsHigh = _mm_setr_epi16(0x100, 0x200, 0x400, 0x800,
+                                            0x1000, 0x2000, 0x4000, (short)0x8000);
+    const __m128i w = _mm_set1_epi16((short)weight);
+    __m128i windowLow;
+    __m128i windowHigh;
+    __m128i vSumLow = _mm_setzero_si128();
+    __m128i vSumHigh = _mm_setzero_si128();
+
+    FindStarts(freeRows, length, hStarts, vStarts);
+    HorizontalWindows(length, window);
+    windowLow = _mm_loadu_si128((const __m128i*)window);
+    windowHigh = _mm_loadu_si128((const __m128i*)window + 1);
+    for (int r = 0; r < COUNT_ROWS; r ++) {
+        __m128i* row = (__m128i*)(counts + r*ROW_LANES);
+        __m128i m;
+
+        // Vertical placements: cmpeq gives -1 per start, so subtract to count
+        m = _mm_set1_epi16((short)vStarts[r]);
+        vSumLow = _mm_sub_epi16(vSumLow, _mm_cmpeq_epi16(_mm_and_si128(m, bitsLow), bitsLow));
+        vSumHigh = _mm_sub_epi16(vSumHigh, _mm_cmpeq_epi16(_mm_and_si128(m, bitsHigh), bitsHigh));
+        if (r >= length) {
+            m = _mm_set1_epi16((short)vStarts[r-length]);
+            vSumLow = _mm_add_epi16(vSumLow, _mm_cmpeq_epi16(_mm_and_si128(m, bitsLow), bitsLow));
+            vSumHigh = _mm_add_epi16(vSumHigh, _mm_cmpeq_epi16(_mm_and_si128(m, bitsHigh), bitsHigh));
+        }
+
+        // Horizontal placements
+        m = _mm_set1_epi16((short)hStarts[r]);
+        _mm_storeu_si128(row, _mm_add_epi16(_mm_loadu_si128(row),
+            _mm_mullo_epi16(_mm_add_epi16(Popcount16(_mm_and_si128(m, windowLow)), vSumLow), w)));
+        _mm_storeu_si128(row + 1, _mm_add_epi16(_mm_loadu_si128(row + 1),
+            _mm_mullo_epi16(_mm_add_epi16(Popcount16(_mm_and_si128(m, windowHigh)), vSumHigh), w)));
+    }
+}
+
+//  AVX2 version of the kernel, see placementKernel.h
+//      Same method as the SSE2 version with each row of counters in one
+//      register of sixteen lanes
+__attribute__((target("avx2")))
+void CountPlacementsAvx2(const uint16_t freeRows[COUNT_ROWS], int length,
+                         uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]) {
+    uint16_t hStarts[COUNT_ROWS];
+    uint16_t vStarts[COUNT_ROWS];
+    uint16_t window[ROW_LANES];
+    const __m256i bits = _mm256_setr_epi16(0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80,
+                                           0x100, 0x200, 0x400, 0x800,
+                                           0x1000, 0x2000, 0x4000, (short)0x8000);
+    const __m256i w = _mm256_set1_epi16((short)weight);
+    __m256i windows;
+    __m256i vSum = _mm256_setzero_si256();
+
+    FindStarts(freeRows, length, hStarts, vStarts);
+    HorizontalWindows(length, window);
+    windows = _mm256_loadu_si256((const __m256i*)window);
+    for (int r = 0; r < COUNT_ROWS; r ++) {
+        __m256i* row = (__m256i*)(counts + r*ROW_LANES);
+        __m256i m;
+
+        // Vertical placements: cmpeq gives -1 per start, so subtract to count
+        m = _mm256_set1_epi16((short)vStarts[r]);
+        vSum = _mm256_sub_epi16(vSum, _mm256_cmpeq_epi16(_mm256_and_si256(m, bits), bits));
+        if (r >= length) {
+            m = _mm256_set1_epi16((short)vStarts[r-length]);
+            vSum = _mm256_add_epi16(vSum, _mm256_cmpeq_epi16(_mm256_and_si256(m, bits), bits));
+        }
+
+        // Horizontal placements
+        m = _mm256_set1_epi16((short)hStarts[r]);
+        _mm256_storeu_si256(row, _mm256_add_epi16(_mm256_loadu_si256(row),
+            _mm256_mullo_epi16(_mm256_add_epi16(Popcount16(_mm256_and_si256(m, windows)), vSum), w)));
+    }
+}
+
+#endif
+
+//  The kernel picked for this CPU
+struct KernelChoice {
+    KernelChoice();
+
+    PlacementCountKernel kernel;
+    const char* name;
+};
+
+//
+//  Constructor, picks the best kernel the CPU supports
+KernelChoice::KernelChoice() {
+    kernel = CountPlacementsScalar;
+    name = "scalar";
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernel = CountPlacementsAvx2;
+        name = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse2")) {
+        kernel = CountPlacementsSse2;
+        name = "sse2";
+    }
+#endif
+}
+
+//  Return the kernel choice, making it on first use
+static const KernelChoice& Choice() {
+    static const KernelChoice choice;
+    return choice;
+}
+
+//  Return the best kernel for this CPU
+//  Parameters:
+//      none
+//  Returns:
+//      the kernel
+//  Possible Errors:
+//      none
+PlacementCountKernel BestPlacementKernel() {
+    return Choice().kernel;
+}
+
+//  Return the name of the best kernel for this CPU
+//  Parameters:
+//      none
+//  Returns:
+//      "avx2", "sse2" or "scalar"
+//  Possible Errors:
+//      none
+const char* BestPlacementKernelName() {
+    return Choice().name;
+}
+
+//  Run the best kernel, see placementKernel.h
+void CountPlacements(const uint16_t freeRows[COUNT_ROWS], int length,
+                     uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]) {
+    Choice().kernel(freeRows, length, weight, counts);
+}
@@ -0,0 +1,57 @@
+// Title: Lab 6 - placementKernel.h
+//
+// Purpose: Declares the placement count kernel: for every square, count
+//          how many placements of a ship of a given length fit on the free
+//          squares of the grid and cover that square.  This is the inner
+//          loop of a density based shot strategy that recounts the map
+//          from scratch, so vectorized versions (SSE2 and AVX2) are
+//          provided next to a scalar one and the best one the CPU supports
+//          is chosen at run time.
+//
+//          The kernel stands alone and is exercised by PlacementBench.
+//          ProbabilityLogic does not use it: it weights each placement by
+//          its prior and the hits it covers, which plain counts cannot
+//          express, and it updates its map incrementally instead of
+//          recounting it.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_PLACEMENTKERNEL_H
+#define BATTLESHIP_PLACEMENTKERNEL_H
+
+#include <cstdint>
+#include "battleship.h"
+
+// Counts are kept in rows of ROW_LANES 16-bit counters, one per column,
+// padded so a row is exactly one AVX2 register (or two SSE2 registers)
+const int ROW_LANES = 16;
+static_assert(COUNT_COLUMNS <= ROW_LANES, "a grid row must fit in one row of counters");
+
+// Signature shared by all versions of the kernel
+//      freeRows - bit c of freeRows[r] is set if square (r, c) may hold a ship
+//      length - length of the ship, 1..max(COUNT_ROWS, COUNT_COLUMNS)
+//      weight - amount added per placement covering a square
+//      counts - counts[r*ROW_LANES + c] is increased for square (r, c),
+//               lanes past COUNT_COLUMNS are left untouched
+typedef void (*PlacementCountKernel)(const uint16_t freeRows[COUNT_ROWS], int length,
+                                     uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]);
+
+void CountPlacementsScalar(const uint16_t freeRows[COUNT_ROWS], int length,
+                           uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]);
+#if defined(__x86_64__) || defined(__i386__)
+void CountPlacementsSse2(const uint16_t freeRows[COUNT_ROWS], int length,
+                         uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]);
+void CountPlacementsAvx2(const uint16_t freeRows[COUNT_ROWS], int length,
+                         uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]);
+#endif
+
+// Best kernel for the CPU we are running on, and its name
+PlacementCountKernel BestPlacementKernel();
+const char* BestPlacementKernelName();
+
+// Run the best kernel
+void CountPlacements(const uint16_t freeRows[COUNT_ROWS], int length,
+                     uint16_t weight, uint16_t counts[COUNT_ROWS*ROW_LANES]);
+
+#endif //BATTLESHIP_PLACEMENTKERNEL_H
@@ -0,0 +1,348 @@
+// Title: Lab 6 - probabilityLogic.cpp
+//
+// Purpose: Implements the ProbabilityLogic class, a CPU shot strategy that
+//          keeps a live map of how many ship placements still consistent
+//          with the outcomes seen so far cover each square, and fires at
+//          the square covered the most.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <assert.h>
+#include "probabilityLogic.h"
+#include "rng.h"
+
+//  Geometry of every placement on the grid, shared by all instances
+//      Placements of length L are numbered [lengthStart[L], lengthStart[L+1]).
+//      The placements of length L covering square s are
+//      cover[coverStart[L][s] .. coverStart[L][s+1]).
+struct PlacementTable {
+    PlacementTable();
+
+    int first[PLACEMENTS_MAX];
+    int step[PLACEMENTS_MAX];
+    int length[PLACEMENTS_MAX];
+    int lengthStart[LENGTH_MAX+2];
+    int coverStart[LENGTH_MAX+1][COUNT_SQUARES+1];
+    short cover[PLACEMENTS_MAX*LENGTH_MAX];
+};
+
+//
+//  Constructor, enumerates the placements of each length and indexes
+//      them by the squares they cover
+PlacementTable::PlacementTable() {
+    int count;
+    int covered;
+
+    count = 0;
+    covered = 0;
+    lengthStart[0] = 0;
+    lengthStart[1] = 0;
+    coverStart[0][0] = 0;
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        coverStart[0][s+1] = 0;
+    }
+    for (int len = 1; len <= LENGTH_MAX; len ++) {
+        int squareCount[COUNT_SQUARES];
+
+        // Horizontal then vertical placements
+        for (int vertical = 0; vertical < 2; vertical ++) {
+            int rows = vertical ? COUNT_ROWS - len + 1 : COUNT_ROWS;
+            int columns = vertical ? COUNT_COLUMNS : COUNT_COLUMNS - len + 1;
+
+            for (int r = 0; r < rows; r ++) {
+                for (int c = 0; c < columns; c ++) {
+                    first[count] = r*COUNT_COLUMNS + c;
+                    step[count] = vertical ? COUNT_COLUMNS : 1;
+                    length[count] = len;
+                    count ++;
+                }
+            }
+        }
+        lengthStart[len+1] = count;
+
+        // Index the placements of this length by the squares they cover
+        for (int s = 0; s < COUNT_SQUARES; s ++) {
+            squareCount[s] = 0;
+        }
+        for (int p = lengthStart[len]; p < count; p ++) {
+            for (int i = 0; i < len; i ++) {
+                squareCount[first[p] + i*step[p]] ++;
+            }
+        }
+        for (int s = 0; s < COUNT_SQUARES; s ++) {
+            coverStart[len][s] = covered;
+            covered += squareCount[s];
+            squareCount[s] = coverStart[len][s];
+        }
+        coverStart[len][COUNT_SQUARES] = covered;
+        for (int p = lengthStart[len]; p < count; p ++) {
+            for (int i = 0; i < len; i ++) {
+                cover[squareCount[first[p] + i*step[p]]++] = (short)p;
+            }
+        }
+    }
+    assert(count <= PLACEMENTS_MAX);
+}
+
+//  Return the placement table, building it on first use
+static const PlacementTable& Placements() {
+    static const PlacementTable table;
+    return table;
+}
+
+//
+//  Constructor
+//  Parameters:
+//      ships - roster of ships the opponent has placed, only sizes are used
+//      shipCount - number of elements in ships
+ProbabilityLogic::ProbabilityLogic(const Ship ships[], int shipCount) {
+    for (int len = 0; len <= LENGTH_MAX; len ++) {
+        _roster[len] = 0;
+    }
+    _lengthCount = 0;
+    for (int i = 0; i < shipCount; i ++) {
+        int len = ships[i].size;
+
+        assert(len > 0 && len <= LENGTH_MAX);
+        if (0 == _roster[len]++) {
+            _lengths[_lengthCount++] = len;
+        }
+    }
+    UsePriors(nullptr);
+}
+
+//  Weight the placements by how often opponents were seen to use them.
+//      Takes effect with the next game
+//  Parameters:
+//      heatmap - the model of the opponents, or nullptr to weight every
+//          placement the same
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::UsePriors(const Heatmap* heatmap) {
+    const PlacementTable& table = Placements();
+
+    for (int p = 0; p < table.lengthStart[LENGTH_MAX+1]; p ++) {
+        _prior[p] = heatmap ? heatmap->GetPrior(table.length[p], table.step[p] != 1, table.first[p]) : 1;
+    }
+    Init();
+}
+
+//  Forget everything learned, ready for a new game.  Every placement of a
+//      ship in the roster starts out possible
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::Init() {
+    const PlacementTable& table = Placements();
+
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        _status[s] = UNKNOWN;
+        _density[s] = 0;
+    }
+    for (int len = 0; len <= LENGTH_MAX; len ++) {
+        _remaining[len] = _roster[len];
+    }
+    for (int i = 0; i < _lengthCount; i ++) {
+        for (int p = table.lengthStart[_lengths[i]]; p < table.lengthStart[_lengths[i]+1]; p ++) {
+            _blocked[p] = false;
+            _hits[p] = 0;
+            _weight[p] = 0;
+            Update(p);
+        }
+    }
+}
+
+//  Fire at the unexplored square with the highest density, breaking ties
+//      at random
+//  Parameters:
+//      row - receives the row of the shot
+//      column - receives the column of the shot
+//      rng - random number generator to break ties with
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      must not be called once every square has been fired at
+void ProbabilityLogic::DetermineShot(int& row, int& column, Rng& rng) {
+    int best;
+    long bestDensity;
+    int ties;
+
+    best = -1;
+    bestDensity = -1;
+    ties = 0;
+    for (int s = 0; s < COUNT_SQUARES; s ++) {
+        if (UNKNOWN != _status[s]) {
+            continue;
+        }
+        if (_density[s] > bestDensity) {
+            best = s;
+            bestDensity = _density[s];
+            ties = 1;
+        }
+        else if (_density[s] == bestDensity && 0 == rng.Below(++ties)) {
+            best = s;
+        }
+    }
+    assert(best >= 0);
+    row = best / COUNT_COLUMNS;
+    column = best % COUNT_COLUMNS;
+}
+
+//  Learn the outcome of a shot and update the density map
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - what happened
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::ReportOutcome(int row, int column, Outcome outcome) {
+    int square = row*COUNT_COLUMNS + column;
+
+    if (SHOT_HERE_BEFORE == outcome || UNKNOWN != _status[square]) {
+        return;
+    }
+    switch (outcome) {
+        case SHOT_MISSED:
+            _status[square] = SHOT_MISS;
+            Block(square);
+            break;
+        case SHIP_HIT:
+            _status[square] = SHOT_HIT;
+            Hit(square);
+            break;
+        case SHIP_SUNK:
+        case GAME_WON:
+            _status[square] = SHOT_HIT;
+            Hit(square);
+            ResolveSunk(square);
+            break;
+        default:
+            break;
+    }
+}
+
+//  Bring the weight of a placement up to date and apply the change to
+//      the density of the squares it covers
+//  Parameters:
+//      placement - placement number
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::Update(int placement) {
+    const PlacementTable& table = Placements();
+    long weight;
+    long delta;
+    int hits;
+
+    hits = _hits[placement] < BOOSTED_HITS_MAX ? _hits[placement] : BOOSTED_HITS_MAX;
+    weight = _blocked[placement] ? 0 : (long)_prior[placement] * (_remaining[table.length[placement]] << (HIT_SHIFT*hits));
+    delta = weight - _weight[placement];
+    if (delta != 0) {
+        int s = table.first[placement];
+
+        for (int i = 0; i < table.length[placement]; i ++, s += table.step[placement]) {
+            _density[s] += delta;
+        }
+        _weight[placement] = weight;
+    }
+}
+
+//  Rule out every placement covering a square
+//  Parameters:
+//      square - square that cannot hold an unsunk ship
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::Block(int square) {
+    const PlacementTable& table = Placements();
+
+    for (int i = 0; i < _lengthCount; i ++) {
+        int len = _lengths[i];
+
+        for (int j = table.coverStart[len][square]; j < table.coverStart[len][square+1]; j ++) {
+            int p = table.cover[j];
+
+            if (!_blocked[p]) {
+                _blocked[p] = true;
+                Update(p);
+            }
+        }
+    }
+}
+
+//  Boost every placement covering a square that was hit
+//  Parameters:
+//      square - square that was hit
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::Hit(int square) {
+    const PlacementTable& table = Placements();
+
+    for (int i = 0; i < _lengthCount; i ++) {
+        int len = _lengths[i];
+
+        for (int j = table.coverStart[len][square]; j < table.coverStart[len][square+1]; j ++) {
+            int p = table.cover[j];
+
+            _hits[p] ++;
+            Update(p);
+        }
+    }
+}
+
+//  A shot sank a ship.  The outcome does not say which one, so take the
+//      longest remaining ship that fits on a line of unresolved hits through
+//      the square, rule out its squares and remove it from the roster
+//  Parameters:
+//      square - square of the sinking shot
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ProbabilityLogic::ResolveSunk(int square) {
+    const PlacementTable& table = Placements();
+    int sunk;
+
+    sunk = -1;
+    for (int i = 0; i < _lengthCount; i ++) {
+        int len = _lengths[i];
+
+        if (0 == _remaining[len]) {
+            continue;
+        }
+        for (int j = table.coverStart[len][square]; j < table.coverStart[len][square+1]; j ++) {
+            int p = table.cover[j];
+
+            if (!_blocked[p] && _hits[p] == len && (sunk < 0 || len > table.length[sunk])) {
+                sunk = p;
+            }
+        }
+    }
+
+    if (sunk >= 0) {
+        int s = table.first[sunk];
+
+        for (int i = 0; i < table.length[sunk]; i ++, s += table.step[sunk]) {
+            Block(s);
+        }
+        _remaining[table.length[sunk]] --;
+        for (int p = table.lengthStart[table.length[sunk]]; p < table.lengthStart[table.length[sunk]+1]; p ++) {
+            Update(p);
+        }
+    }
+    else {
+        Block(square);
+    }
+}
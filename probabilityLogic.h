@@ -0,0 +1,70 @@
+// Title: Lab 6 - probabilityLogic.h
+//
+// Purpose: Declares the ProbabilityLogic class, a CPU shot strategy that
+//          keeps a live map of how many ship placements still consistent
+//          with the outcomes seen so far cover each square, and fires at
+//          the square covered the most.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_PROBABILITYLOGIC_H
+#define BATTLESHIP_PROBABILITYLOGIC_H
+
+#include "cpulogic.h"
+#include "heatmap.h"
+
+// Longest ship that fits on the grid
+const int LENGTH_MAX = COUNT_ROWS > COUNT_COLUMNS ? COUNT_ROWS : COUNT_COLUMNS;
+
+// Bound on the ways to place one ship of each length 1..LENGTH_MAX
+const int PLACEMENTS_MAX = 2*LENGTH_MAX*COUNT_SQUARES;
+
+// Each unresolved hit a placement covers multiplies its weight by 2^HIT_SHIFT,
+// counting at most BOOSTED_HITS_MAX hits.  The boosted ship count is an int,
+// good for up to 2^(31-HIT_SHIFT*BOOSTED_HITS_MAX) - 1 ships of one length;
+// times a prior of up to HEATMAP_PRIOR_MAX the weights, and the densities
+// summing them, need the 64-bit long
+const int HIT_SHIFT = 4;
+const int BOOSTED_HITS_MAX = 5;
+
+//  Probability density shot strategy
+//      Every placement (ship length, orientation, start square) has a weight:
+//      zero if it covers a miss or a sunk ship, otherwise the number of
+//      remaining ships of that length, boosted for each unresolved hit it
+//      covers, and multiplied by its prior if a Heatmap of where opponents
+//      place their ships is given.  The density of a square is the sum of
+//      the weights of the placements covering it.  A shot only changes the placements that
+//      cover the square shot, so the map is updated incrementally.
+class ProbabilityLogic : public ShotStrategy {
+public:
+    ProbabilityLogic(const Ship ships[] = CLASSIC_SHIPS, int shipCount = CLASSIC_SHIP_COUNT);
+
+    void Init() override;
+    void DetermineShot(int& row, int& column, Rng& rng) override;
+    void ReportOutcome(int row, int column, Outcome outcome) override;
+
+    void UsePriors(const Heatmap* heatmap);
+
+private:
+    void Update(int placement);
+    void Block(int square);
+    void Hit(int square);
+    void ResolveSunk(int square);
+
+    // Ships to find
+    int _roster[LENGTH_MAX+1];          // number of ships of each length
+    int _lengths[LENGTH_MAX];           // distinct lengths in the roster
+    int _lengthCount;
+    int _prior[PLACEMENTS_MAX];         // 1 for every placement without a Heatmap
+
+    // Game state
+    ShotStatus _status[COUNT_SQUARES];
+    int _remaining[LENGTH_MAX+1];       // ships of each length not yet sunk
+    bool _blocked[PLACEMENTS_MAX];
+    unsigned char _hits[PLACEMENTS_MAX];
+    long _weight[PLACEMENTS_MAX];
+    long _density[COUNT_SQUARES];
+};
+
+#endif //BATTLESHIP_PROBABILITYLOGIC_H
@@ -0,0 +1,877 @@
+// Title: Lab 6 - renderBench.cpp
+//
+// Purpose: Benchmarks of drawing the game: the initial MainWindow::Display,
+//          the first and a repeated GridWindow::Display, a whole game
+//          replayed shot by shot, resizing the terminal, typing a line,
+//          and laying out a wall of 64 grids again after one or all of
+//          them changed.  The windows draw on an ncurses screen made by
+//          newterm on a pipe, so every benchmark reports the bytes written
+//          to the terminal, the curses calls the windowing classes made and
+//          the nanoseconds per frame.  A frame is one Display call, one
+//          shot and its response when replaying, one key typed, or one
+//          layout.
+//
+//          Usage: RenderBench [-time seconds] [-filter text] [-json file]
+//                             [-label text] [-term type] [-replay file.log]
+//
+//          Each benchmark draws frames for about seconds (default 0.2)
+//          five times over and reports the median run.  The game replayed
+//          is the given replay log, or else one made up from a fixed seed.
+//          The terminal type (default xterm) decides the escape sequences
+//          and so the byte counts.  Results can be written as JSON like
+//          those of BattleshipBench.
+//
+//          The curses calls are counted by wrapping them at link time, see
+//          CMakeLists.txt, so calls made inside ncurses are not counted.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "commandWindow.h"
+#include "gridWindow.h"
+#include "replayLog.h"
+
+using namespace std;
+
+const double DEFAULT_SECONDS = 0.2;
+const int RUNS = 5;
+const uint64_t SEED = 2020;
+const char* const DEFAULT_TERMINAL = "xterm";
+
+// Size of the terminal, room for the whole game
+const char* const TERMINAL_LINES = "50";
+const char* const TERMINAL_COLUMNS = "132";
+
+// Smaller terminal sizes the resize benchmarks switch to: one the game
+// still fits in and one that cuts it off
+const int FIT_LINES = 40;
+const int FIT_COLUMNS = 80;
+const int SMALL_LINES = 20;
+const int SMALL_COLUMNS = 40;
+
+// Grids on the wall laid out by the layout benchmarks, and layouts per batch
+const int DASHBOARD_ROWS = 8;
+const int DASHBOARD_COLUMNS = 8;
+const int LAYOUT_BATCH = 64;
+
+// A line typed by the typing benchmark, with a typo and its BACKSPACE
+const char* const TYPED_LINE = "B8\1777\n";
+
+// Bytes the pipe holds, more than any frame writes so drawing never blocks
+const int PIPE_BYTES = 1 << 20;
+
+// Curses calls made by the windowing classes, see the wrappers below
+static long cursesCalls = 0;
+static long refreshCalls = 0;
+
+// The curses functions the windowing classes call, as wrapped by the linker
+extern "C" {
+    int __real_box(WINDOW* window, chtype verch, chtype horch);
+    int __real_delwin(WINDOW* window);
+    int __real_doupdate();
+    int __real_mvwin(WINDOW* window, int y, int x);
+    WINDOW* __real_newwin(int lines, int columns, int y, int x);
+    int __real_refresh();
+    int __real_waddch(WINDOW* window, const chtype ch);
+    int __real_waddchnstr(WINDOW* window, const chtype* cells, int count);
+    int __real_wattr_on(WINDOW* window, attr_t attrib, void* options);
+    int __real_wattr_off(WINDOW* window, attr_t attrib, void* options);
+    int __real_wclear(WINDOW* window);
+    int __real_werase(WINDOW* window);
+    int __real_wmove(WINDOW* window, int y, int x);
+    int __real_wnoutrefresh(WINDOW* window);
+    int __real_wrefresh(WINDOW* window);
+    int __real_wresize(WINDOW* window, int lines, int columns);
+
+    int __wrap_box(WINDOW* window, chtype verch, chtype horch) {
+        cursesCalls ++;
+        return __real_box(window, verch, horch);
+    }
+
+    int __wrap_delwin(WINDOW* window) {
+        cursesCalls ++;
+        return __real_delwin(window);
+    }
+
+    int __wrap_doupdate() {
+        cursesCalls ++;
+        refreshCalls ++;
+        return __real_doupdate();
+    }
+
+    int __wrap_mvwin(WINDOW* window, int y, int x) {
+        cursesCalls ++;
+        return __real_mvwin(window, y, x);
+    }
+
+    WINDOW* __wrap_newwin(int lines, int columns, int y, int x) {
+        cursesCalls ++;
+        return __real_newwin(lines, columns, y, x);
+    }
+
+    int __wrap_refresh() {
+        cursesCalls ++;
+        refreshCalls ++;
+        return __real_refresh();
+    }
+
+    int __wrap_waddch(WINDOW* window, const chtype ch) {
+        cursesCalls ++;
+        return __real_waddch(window, ch);
+    }
+
+    int __wrap_waddchnstr(WINDOW* window, const chtype* cells, int count) {
+        cursesCalls ++;
+        return __real_waddchnstr(window, cells, count);
+    }
+
+    int __wrap_wattr_on(WINDOW* window, attr_t attrib, void* options) {
+        cursesCalls ++;
+        return __real_wattr_on(window, attrib, options);
+    }
+
+    int __wrap_wattr_off(WINDOW* window, attr_t attrib, void* options) {
+        cursesCalls ++;
+        return __real_wattr_off(window, attrib, options);
+    }
+
+    int __wrap_wclear(WINDOW* window) {
+        cursesCalls ++;
+        return __real_wclear(window);
+    }
+
+    int __wrap_werase(WINDOW* window) {
+        cursesCalls ++;
+        return __real_werase(window);
+    }
+
+    int __wrap_wmove(WINDOW* window, int y, int x) {
+        cursesCalls ++;
+        return __real_wmove(window, y, x);
+    }
+
+    int __wrap_wnoutrefresh(WINDOW* window) {
+        cursesCalls ++;
+        return __real_wnoutrefresh(window);
+    }
+
+    int __wrap_wrefresh(WINDOW* window) {
+        cursesCalls ++;
+        refreshCalls ++;
+        return __real_wrefresh(window);
+    }
+
+    int __wrap_wresize(WINDOW* window, int lines, int columns) {
+        cursesCalls ++;
+        return __real_wresize(window, lines, columns);
+    }
+
+    int __wrap_mvwprintw(WINDOW* window, int y, int x, const char* format, ...) {
+        va_list args;
+        int result;
+
+        cursesCalls ++;
+        if (ERR == __real_wmove(window, y, x)) {
+            return ERR;
+        }
+        va_start(args, format);
+        result = vw_printw(window, format, args);
+        va_end(args);
+        return result;
+    }
+}
+
+//  The terminal the screens draw on: a pipe, emptied after every frame
+//      to count the bytes written to it, and another the keys are typed in
+class Terminal {
+public:
+    Terminal() : _readFd(-1), _keyFd(-1), _output(nullptr), _input(nullptr) {}
+
+    ~Terminal() {
+        if (_output) {
+            fclose(_output);
+        }
+        if (_input) {
+            fclose(_input);
+        }
+        if (_readFd >= 0) {
+            close(_readFd);
+        }
+        if (_keyFd >= 0) {
+            close(_keyFd);
+        }
+    }
+
+    //  Make the pipes
+    //  Parameters:
+    //      none
+    //  Returns:
+    //      success/failure
+    //  Possible Errors:
+    //      out of file descriptors
+    bool Open() {
+        int fds[2];
+        int keyFds[2];
+
+        if (pipe(fds) != 0) {
+            return false;
+        }
+        fcntl(fds[1], F_SETPIPE_SZ, PIPE_BYTES);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        _readFd = fds[0];
+        _output = fdopen(fds[1], "w");
+        if (pipe(keyFds) != 0) {
+            return false;
+        }
+        _keyFd = keyFds[1];
+        _input = fdopen(keyFds[0], "r");
+        return _output && _input;
+    }
+
+    //  Type keys for the screen to read
+    //  Parameters:
+    //      keys - the keys
+    //  Returns:
+    //      success/failure
+    //  Possible Errors:
+    //      none expected, the keys fit in the pipe
+    bool Type(const string& keys) {
+        return write(_keyFd, keys.data(), keys.length()) == (ssize_t)keys.length();
+    }
+
+    //  Read everything written so far
+    //  Parameters:
+    //      none
+    //  Returns:
+    //      number of bytes read
+    //  Possible Errors:
+    //      none
+    long Drain() {
+        char buffer[1 << 16];
+        long bytes = 0;
+        ssize_t count;
+
+        while ((count = read(_readFd, buffer, sizeof(buffer))) > 0 || (count < 0 && EINTR == errno)) {
+            if (count > 0) {
+                bytes += count;
+            }
+        }
+        return bytes;
+    }
+
+    FILE* GetOutput() const { return _output; }
+    FILE* GetInput() const { return _input; }
+
+private:
+    int _readFd;
+    int _keyFd;
+    FILE* _output;
+    FILE* _input;
+};
+
+// A shot of a game
+//      atUser - whether the CPU fired it at the user
+//      row, column - the square
+struct Shot {
+    bool atUser;
+    int row;
+    int column;
+};
+
+// A game to replay
+//      user, cpu - the grids before the first shot
+//      shots - the shots in order
+struct Game {
+    Grid user;
+    Grid cpu;
+    vector<Shot> shots;
+};
+
+//  The windows of the game put together as GameBoard::ShowInitialDisplay
+//      does, drawing on a Terminal
+class Screen {
+public:
+    Screen() :
+            _mainWindow(true, "BATTLESHIP", "", CENTER, CENTER, DEFAULT_COLOR, DEFAULT_COLOR, A_STANDOUT),
+            _user("User", true),
+            _cpu("CPU", false),
+            _gridGrouping("GridGrouping") {
+        _user.Init();
+        _cpu.Init();
+        _gridGrouping.AddChild(&_user.DisplayArea());
+        _gridGrouping.AddChild(&_cpu.DisplayArea());
+        _commandWindow.Init();
+        _mainWindow.AddChild(&_gridGrouping);
+        _mainWindow.AddChild(&_commandWindow.DisplayArea());
+    }
+
+    bool UseTerminal(const string& type, Terminal& terminal) {
+        return _mainWindow.UseTerminal(type, terminal.GetOutput(), terminal.GetInput());
+    }
+
+    bool DisplayMain() {
+        int fgColors[] = { COLOR_WHITE, COLOR_BLACK, COLOR_BLACK, COLOR_WHITE, COLOR_WHITE, COLOR_BLACK };
+        int bgColors[] = { COLOR_RED, COLOR_GREEN, COLOR_YELLOW, COLOR_BLUE, COLOR_MAGENTA, COLOR_CYAN };
+
+        return _mainWindow.Display(fgColors, bgColors, sizeof(fgColors)/sizeof(fgColors[0]));
+    }
+
+    void DisplayGrids() {
+        _user.Display();
+        _cpu.Display();
+    }
+
+    void HandleResize() {
+        _mainWindow.HandleResize();
+    }
+
+    GridWindow& GetGrid(bool forUser) { return forUser ? _user : _cpu; }
+    CommandWindow& GetCommandWindow() { return _commandWindow; }
+
+private:
+    // Constructed first so it is destroyed after the windows on it
+    MainWindow _mainWindow;
+    GridWindow _user;
+    GridWindow _cpu;
+    HGroup _gridGrouping;
+    CommandWindow _commandWindow;
+};
+
+//  A benchmark: Setup prepares a screen outside the timing, Run draws on
+//      it and returns the number of frames drawn
+class Benchmark {
+public:
+    Benchmark(const string& name, Terminal& terminal, const string& type)
+        : _name(name), _terminal(terminal), _type(type) {}
+    virtual ~Benchmark() {}
+
+    const string& GetName() const { return _name; }
+    virtual bool Setup() = 0;
+    virtual long Run() = 0;
+
+protected:
+    //  Replace the screen with a new one on the terminal
+    //  Parameters:
+    //      displayMain - whether to display the main window
+    //      displayGrids - whether to display the grids as well
+    //  Returns:
+    //      success/failure
+    //  Possible Errors:
+    //      unknown terminal type
+    bool NewScreen(bool displayMain, bool displayGrids) {
+        _screen.reset();
+        _screen.reset(new Screen());
+        if (!_screen->UseTerminal(_type, _terminal)) {
+            return false;
+        }
+        if (displayMain && !_screen->DisplayMain()) {
+            return false;
+        }
+        if (displayGrids) {
+            _screen->DisplayGrids();
+        }
+        return true;
+    }
+
+    const string& GetType() const { return _type; }
+    Terminal& GetTerminal() { return _terminal; }
+
+    unique_ptr<Screen> _screen;
+
+private:
+    string _name;
+    Terminal& _terminal;
+    string _type;
+};
+
+//  The first display of the main window with all its subwindows
+class MainDisplayBench : public Benchmark {
+public:
+    MainDisplayBench(Terminal& terminal, const string& type)
+        : Benchmark("MainWindow::Display", terminal, type) {}
+
+    bool Setup() override {
+        return NewScreen(false, false);
+    }
+
+    long Run() override {
+        _screen->DisplayMain();
+        return 1;
+    }
+};
+
+//  The first display of both grids: the lines and the squares
+class GridDisplayBench : public Benchmark {
+public:
+    GridDisplayBench(Terminal& terminal, const string& type)
+        : Benchmark("GridWindow::Display", terminal, type) {}
+
+    bool Setup() override {
+        return NewScreen(true, false);
+    }
+
+    long Run() override {
+        _screen->DisplayGrids();
+        return 1;
+    }
+};
+
+//  Displaying both grids again, which the shadow buffer should make free
+class GridRedisplayBench : public Benchmark {
+public:
+    GridRedisplayBench(Terminal& terminal, const string& type)
+        : Benchmark("GridWindow::Display/again", terminal, type) {}
+
+    bool Setup() override {
+        return _screen || NewScreen(true, true);
+    }
+
+    long Run() override {
+        _screen->DisplayGrids();
+        return 1;
+    }
+};
+
+//  Resizing the terminal back and forth between two sizes the game fits
+//      in, or between the full size and one too small for it, redrawing
+//      the whole game each time.  A frame is one resize
+class ResizeBench : public Benchmark {
+public:
+    ResizeBench(Terminal& terminal, const string& type, bool tooSmall)
+        : Benchmark(tooSmall ? "MainWindow::HandleResize/cut" : "MainWindow::HandleResize", terminal, type),
+          _tooSmall(tooSmall), _shrink(true) {}
+
+    bool Setup() override {
+        return _screen || NewScreen(true, true);
+    }
+
+    long Run() override {
+        if (_shrink) {
+            resize_term(_tooSmall ? SMALL_LINES : FIT_LINES, _tooSmall ? SMALL_COLUMNS : FIT_COLUMNS);
+        }
+        else {
+            resize_term(atoi(TERMINAL_LINES), atoi(TERMINAL_COLUMNS));
+        }
+        _shrink = !_shrink;
+        _screen->HandleResize();
+        return 1;
+    }
+
+private:
+    bool _tooSmall;
+    bool _shrink;
+};
+
+//  Typing a line into the command window, a typo and its BACKSPACE
+//      included.  Each key draws only what it changes.  A frame is one key
+class TypingBench : public Benchmark {
+public:
+    TypingBench(Terminal& terminal, const string& type)
+        : Benchmark("InputWindow::GetInput", terminal, type) {}
+
+    bool Setup() override {
+        return _screen || NewScreen(true, true);
+    }
+
+    long Run() override {
+        string keys = TYPED_LINE;
+
+        if (!GetTerminal().Type(keys)) {
+            return 0;
+        }
+        _screen->GetCommandWindow().GetLine();
+        return (long)keys.length();
+    }
+};
+
+//  A whole game replayed the way the -replay option of the game does, each
+//      shot with its response
+class ReplayBench : public Benchmark {
+public:
+    ReplayBench(Terminal& terminal, const string& type, const Game& game)
+        : Benchmark("ReplayGame", terminal, type), _game(game) {}
+
+    bool Setup() override {
+        if (!NewScreen(true, true)) {
+            return false;
+        }
+        return _screen->GetGrid(true).SetGrid(_game.user) && _screen->GetGrid(false).SetGrid(_game.cpu);
+    }
+
+    long Run() override {
+        long count = (long)_game.shots.size();
+
+        for (long i = 0; i < count; i ++) {
+            const Shot& shot = _game.shots[i];
+            ostringstream response;
+            Outcome outcome;
+
+            _screen->GetGrid(shot.atUser).FireShot(shot.row, shot.column, outcome);
+            response << "Shot " << i + 1 << " of " << count << ": "
+                     << (shot.atUser ? "CPU" : "User") << " fired at "
+                     << (char)('A' + shot.column) << shot.row << " and " << (SHOT_MISSED == outcome ? "missed" : "hit") << ".";
+            _screen->GetCommandWindow().WriteResponse(response.str());
+        }
+        return count;
+    }
+
+private:
+    const Game& _game;
+};
+
+//  Laying out a wall of DASHBOARD_ROWS x DASHBOARD_COLUMNS grids again
+//      after the layout of one grid, or of every grid, was invalidated.
+//      Nothing is displayed, a frame is one layout
+class LayoutBench : public Benchmark {
+public:
+    LayoutBench(Terminal& terminal, const string& type, bool invalidateAll)
+        : Benchmark(invalidateAll ? "MainWindow::Layout/all" : "MainWindow::Layout/one", terminal, type),
+          _invalidateAll(invalidateAll), _next(0) {}
+
+    bool Setup() override {
+        if (_mainWindow) {
+            return true;
+        }
+        _mainWindow.reset(new MainWindow(true, "DASHBOARD"));
+        for (int row = 0; row < DASHBOARD_ROWS; row ++) {
+            _rows.emplace_back(new HGroup("Row"));
+            for (int column = 0; column < DASHBOARD_COLUMNS; column ++) {
+                _grids.emplace_back(new GridWindow("Game", false));
+                _grids.back()->Init();
+                _rows.back()->AddChild(&_grids.back()->DisplayArea());
+            }
+            _mainWindow->AddChild(_rows.back().get());
+        }
+        if (!_mainWindow->UseTerminal(GetType(), GetTerminal().GetOutput(), GetTerminal().GetInput())) {
+            return false;
+        }
+        _mainWindow->Layout();
+        return true;
+    }
+
+    long Run() override {
+        for (int i = 0; i < LAYOUT_BATCH; i ++) {
+            if (_invalidateAll) {
+                for (unique_ptr<GridWindow>& grid : _grids) {
+                    grid->DisplayArea().InvalidateLayout();
+                }
+            }
+            else {
+                _grids[_next]->DisplayArea().InvalidateLayout();
+                _next = (_next + 1) % _grids.size();
+            }
+            _mainWindow->Layout();
+        }
+        return LAYOUT_BATCH;
+    }
+
+private:
+    // Constructed first so it is destroyed after the windows in it
+    unique_ptr<MainWindow> _mainWindow;
+    vector<unique_ptr<HGroup>> _rows;
+    vector<unique_ptr<GridWindow>> _grids;
+    bool _invalidateAll;
+    size_t _next;
+};
+
+// Result of a benchmark
+//      name - name of the benchmark
+//      frames - frames drawn in the median run
+//      nsPerFrame - nanoseconds per frame in the median run
+//      nsPerFrameMin - nanoseconds per frame in the fastest run
+//      bytesPerFrame - bytes written to the terminal per frame over all runs
+//      callsPerFrame - curses calls per frame over all runs
+//      refreshesPerFrame - refresh and wrefresh calls per frame over all runs
+struct BenchResult {
+    string name;
+    long frames;
+    double nsPerFrame;
+    double nsPerFrameMin;
+    double bytesPerFrame;
+    double callsPerFrame;
+    double refreshesPerFrame;
+};
+
+//  Make up a game: the classic ships placed at random and each side firing
+//      at the squares in a random order until one side has sunk every ship
+//  Parameters:
+//      game - receives the game
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void MakeGame(Game& game) {
+    Rng rng(SEED);
+    Grid user;
+    Grid cpu;
+    int order[2][COUNT_SQUARES];
+    Outcome outcome;
+
+    game.user.RandomlyPlaceShips(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, rng);
+    game.cpu.RandomlyPlaceShips(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, rng);
+    user = game.user;
+    cpu = game.cpu;
+    for (int side = 0; side < 2; side ++) {
+        for (int i = 0; i < COUNT_SQUARES; i ++) {
+            int j = rng.Below(i + 1);
+
+            order[side][i] = order[side][j];
+            order[side][j] = i;
+        }
+    }
+    game.shots.clear();
+    outcome = SHOT_MISSED;
+    for (int i = 0; i < COUNT_SQUARES && GAME_WON != outcome; i ++) {
+        for (int side = 0; side < 2 && GAME_WON != outcome; side ++) {
+            Shot shot { 1 == side, order[side][i] / COUNT_COLUMNS, order[side][i] % COUNT_COLUMNS };
+
+            (shot.atUser ? user : cpu).FireShot(shot.row, shot.column, outcome);
+            game.shots.push_back(shot);
+        }
+    }
+}
+
+//  Read the game from a replay log
+//  Parameters:
+//      fileName - name of the log
+//      game - receives the game
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      the log cannot be read, grids not the size of the game's
+bool ReadGame(const string& fileName, Game& game) {
+    ReplayLog log;
+
+    if (!log.Load(fileName)) {
+        return false;
+    }
+    log.Seek(0, game.user, game.cpu);
+    if (game.user.GetRows() != COUNT_ROWS || game.user.GetColumns() != COUNT_COLUMNS) {
+        return false;
+    }
+    game.shots.resize(log.GetShotCount());
+    for (long i = 0; i < log.GetShotCount(); i ++) {
+        log.GetShot(i, game.shots[i].atUser, game.shots[i].row, game.shots[i].column);
+    }
+    return true;
+}
+
+//  Run a benchmark RUNS times, each run drawing frames for about seconds
+//  Parameters:
+//      bench - the benchmark
+//      terminal - the terminal it draws on
+//      seconds - time to spend per run
+//      result - receives the result of the median run
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      the screen cannot be set up
+bool Measure(Benchmark& bench, Terminal& terminal, double seconds, BenchResult& result) {
+    vector<pair<double, long>> runs;
+    long frames;
+    long bytes;
+    long calls;
+    long refreshes;
+
+    // One untimed run to warm the caches
+    if (!bench.Setup()) {
+        return false;
+    }
+    bench.Run();
+
+    frames = 0;
+    bytes = 0;
+    calls = 0;
+    refreshes = 0;
+    for (int run = 0; run < RUNS; run ++) {
+        chrono::duration<double> elapsed(0);
+        long runFrames = 0;
+
+        while (elapsed.count() < seconds) {
+            chrono::steady_clock::time_point start;
+            long callsBefore;
+            long refreshesBefore;
+
+            if (!bench.Setup()) {
+                return false;
+            }
+            terminal.Drain();
+            callsBefore = cursesCalls;
+            refreshesBefore = refreshCalls;
+            start = chrono::steady_clock::now();
+            runFrames += bench.Run();
+            elapsed += chrono::steady_clock::now() - start;
+            calls += cursesCalls - callsBefore;
+            refreshes += refreshCalls - refreshesBefore;
+            bytes += terminal.Drain();
+        }
+        runs.push_back(make_pair(elapsed.count()*1e9/runFrames, runFrames));
+        frames += runFrames;
+    }
+    sort(runs.begin(), runs.end());
+
+    result.name = bench.GetName();
+    result.frames = runs[RUNS/2].second;
+    result.nsPerFrame = runs[RUNS/2].first;
+    result.nsPerFrameMin = runs[0].first;
+    result.bytesPerFrame = (double)bytes / frames;
+    result.callsPerFrame = (double)calls / frames;
+    result.refreshesPerFrame = (double)refreshes / frames;
+    return true;
+}
+
+//  Write the results as JSON
+//  Parameters:
+//      fileName - name of the file
+//      label - name of the build
+//      type - terminal type the frames were drawn for
+//      results - the results
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be created or written
+bool WriteJson(const string& fileName, const string& label, const string& type,
+               const vector<BenchResult>& results) {
+    ofstream file(fileName);
+
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "{\n  \"label\": \"";
+    for (char c : label) {
+        if ('"' == c || '\\' == c) {
+            file << '\\';
+        }
+        file << c;
+    }
+    file << "\",\n  \"build_type\": \"" << BUILD_TYPE << "\",\n  \"terminal\": \"" << type
+         << "\",\n  \"benchmarks\": [\n" << setprecision(6);
+    for (size_t i = 0; i < results.size(); i ++) {
+        const BenchResult& result = results[i];
+
+        file << "    { \"name\": \"" << result.name << "\", \"frames\": " << result.frames
+             << ", \"ns_per_frame\": " << result.nsPerFrame
+             << ", \"ns_per_frame_min\": " << result.nsPerFrameMin
+             << ", \"bytes_per_frame\": " << result.bytesPerFrame
+             << ", \"calls_per_frame\": " << result.callsPerFrame
+             << ", \"refreshes_per_frame\": " << result.refreshesPerFrame << " }"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    file.close();
+    return !file.fail();
+}
+
+int main(int argc, char* argv[]) {
+    double seconds;
+    string filter;
+    string jsonFile;
+    string label;
+    string type;
+    string replayFile;
+    Terminal terminal;
+    Game game;
+    vector<unique_ptr<Benchmark>> benches;
+    vector<BenchResult> results;
+
+    seconds = DEFAULT_SECONDS;
+    type = DEFAULT_TERMINAL;
+    for (int i = 1; i < argc; i ++) {
+        string option = argv[i];
+
+        if (i + 1 < argc && "-time" == option) {
+            seconds = atof(argv[++i]);
+        }
+        else if (i + 1 < argc && "-filter" == option) {
+            filter = argv[++i];
+        }
+        else if (i + 1 < argc && "-json" == option) {
+            jsonFile = argv[++i];
+        }
+        else if (i + 1 < argc && "-label" == option) {
+            label = argv[++i];
+        }
+        else if (i + 1 < argc && "-term" == option) {
+            type = argv[++i];
+        }
+        else if (i + 1 < argc && "-replay" == option) {
+            replayFile = argv[++i];
+        }
+        else {
+            seconds = 0;
+            break;
+        }
+    }
+    if (seconds <= 0) {
+        cerr << "Usage: " << argv[0] << " [-time seconds] [-filter text] [-json file]" << endl;
+        cerr << "       " << string(strlen(argv[0]), ' ') << " [-label text] [-term type] [-replay file.log]" << endl;
+        return 1;
+    }
+    if (replayFile.empty()) {
+        MakeGame(game);
+    }
+    else if (!ReadGame(replayFile, game)) {
+        cerr << "Cannot replay " << replayFile << endl;
+        return 1;
+    }
+
+    // ncurses takes the size of a terminal that is not a tty from these
+    setenv("LINES", TERMINAL_LINES, 1);
+    setenv("COLUMNS", TERMINAL_COLUMNS, 1);
+    if (!terminal.Open()) {
+        cerr << "Cannot make a pipe for the terminal" << endl;
+        return 1;
+    }
+
+    benches.emplace_back(new MainDisplayBench(terminal, type));
+    benches.emplace_back(new GridDisplayBench(terminal, type));
+    benches.emplace_back(new GridRedisplayBench(terminal, type));
+    benches.emplace_back(new ReplayBench(terminal, type, game));
+    benches.emplace_back(new ResizeBench(terminal, type, false));
+    benches.emplace_back(new ResizeBench(terminal, type, true));
+    benches.emplace_back(new TypingBench(terminal, type));
+    benches.emplace_back(new LayoutBench(terminal, type, false));
+    benches.emplace_back(new LayoutBench(terminal, type, true));
+
+    cout << left << setw(28) << "benchmark" << right << setw(14) << "ns/frame"
+         << setw(14) << "bytes/frame" << setw(14) << "calls/frame" << setw(16) << "refresh/frame" << endl;
+    for (unique_ptr<Benchmark>& bench : benches) {
+        BenchResult result;
+
+        if (bench->GetName().find(filter) == string::npos) {
+            continue;
+        }
+        if (!Measure(*bench, terminal, seconds, result)) {
+            cerr << "Cannot display on a " << type << " terminal" << endl;
+            return 1;
+        }
+        results.push_back(result);
+        cout << left << setw(28) << result.name << right << fixed
+             << setw(14) << setprecision(1) << result.nsPerFrame
+             << setw(14) << result.bytesPerFrame
+             << setw(14) << result.callsPerFrame
+             << setw(16) << setprecision(2) << result.refreshesPerFrame << endl;
+    }
+
+    // Delete the screens before the terminal is closed
+    benches.clear();
+    if (!jsonFile.empty() && !WriteJson(jsonFile, label, type, results)) {
+        cerr << "Cannot write " << jsonFile << endl;
+        return 1;
+    }
+    return 0;
+}
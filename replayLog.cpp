@@ -0,0 +1,321 @@
+// Title: Lab 6 - replayLog.cpp
+//
+// Purpose: Implements the classes that write and play back the replay log
+//          declared in replayLog.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <cstring>
+#include <iterator>
+#include "replayLog.h"
+
+//  Return whether a shot outcome means a ship was hit
+//  Parameters:
+//      outcome - outcome of the shot
+//  Returns:
+//      true for SHIP_HIT, SHIP_SUNK and GAME_WON
+//  Possible Errors:
+//      none
+static inline bool IsHit(Outcome outcome) {
+    return SHIP_HIT == outcome || SHIP_SUNK == outcome || GAME_WON == outcome;
+}
+
+//
+//  Constructor
+ReplayWriter::ReplayWriter() {
+    _columns = 0;
+}
+
+//  Create a replay log and write its header and the layouts of both grids
+//  Parameters:
+//      fileName - name of the log
+//      seed - random seed the game was started with
+//      user - the user's grid, before any shot
+//      cpu - the CPU's grid, the same size as the user's
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      grids of different sizes or with too many squares, file cannot be
+//      created or written
+bool ReplayWriter::Open(const string& fileName, uint64_t seed, const Grid& user, const Grid& cpu) {
+    unsigned char header[REPLAY_HEADER_BYTES];
+
+    Close();
+    if (user.GetRows() != cpu.GetRows() || user.GetColumns() != cpu.GetColumns()
+        || user.GetRows()*user.GetColumns() > REPLAY_SQUARES_MAX) {
+        return false;
+    }
+    _file.open(fileName, ios::binary | ios::trunc);
+    if (_file.fail()) {
+        return false;
+    }
+    memcpy(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    header[4] = (unsigned char)REPLAY_VERSION;
+    header[5] = (unsigned char)(REPLAY_VERSION >> 8);
+    header[6] = (unsigned char)user.GetRows();
+    header[7] = (unsigned char)user.GetColumns();
+    for (int i = 0; i < 8; i ++) {
+        header[8 + i] = (unsigned char)(seed >> (8*i));
+    }
+    _file.write((const char*)header, sizeof(header));
+    _columns = user.GetColumns();
+    if (!WriteLayout(user) || !WriteLayout(cpu)) {
+        Close();
+        return false;
+    }
+    _file.flush();
+    return !_file.fail();
+}
+
+//  Return whether a log is being written
+//  Parameters:
+//      none
+//  Returns:
+//      true if open
+//  Possible Errors:
+//      none
+bool ReplayWriter::IsOpen() const {
+    return _file.is_open();
+}
+
+//  Append a shot to the log.  Shots must be recorded in the order they
+//      are fired, the user's first, and shots off the grid not at all
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - outcome of the shot
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      no log open, the file cannot be written
+bool ReplayWriter::RecordShot(int row, int column, Outcome outcome) {
+    if (!_file.is_open()) {
+        return false;
+    }
+    _file.put((char)((row*_columns + column) | (IsHit(outcome) ? REPLAY_HIT : 0)));
+    _file.flush();
+    return !_file.fail();
+}
+
+//  Close the log
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void ReplayWriter::Close() {
+    if (_file.is_open()) {
+        _file.close();
+    }
+    _file.clear();
+}
+
+//  Write the ship layout of a grid
+//  Parameters:
+//      grid - grid whose ships are written
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      a ship name longer than 255 characters, the file cannot be written
+bool ReplayWriter::WriteLayout(const Grid& grid) {
+    _file.put((char)grid.GetShipsDeployed());
+    for (int i = 0; i < grid.GetShipsDeployed(); i ++) {
+        Ship ship;
+
+        grid.GetShip(i, ship);
+        if (ship.name.size() > 255) {
+            return false;
+        }
+        _file.put((char)ship.name.size());
+        _file.write(ship.name.data(), ship.name.size());
+        _file.put((char)(ship.size | (ship.isVertical ? REPLAY_VERTICAL : 0)));
+        _file.put((char)(ship.startRow*_columns + ship.startColumn));
+    }
+    return !_file.fail();
+}
+
+//
+//  Constructor
+ReplayLog::ReplayLog() {
+    _seed = 0;
+    _columns = COUNT_COLUMNS;
+}
+
+//  Read a replay log.  Every shot is played against the layouts to check
+//      it against its hit bit, keeping a snapshot of both grids every
+//      REPLAY_SNAPSHOT_INTERVAL shots along the way
+//  Parameters:
+//      fileName - name of the log
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be read, wrong magic or version, bad layouts, a shot
+//      off the grid or that does not match the layouts
+bool ReplayLog::Load(const string& fileName) {
+    ifstream file(fileName, ios::binary);
+    vector<unsigned char> data;
+    size_t offset;
+    int rows;
+    Grid user;
+    Grid cpu;
+
+    _shots.clear();
+    _snapshots.clear();
+    if (file.fail()) {
+        return false;
+    }
+    data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (data.size() < REPLAY_HEADER_BYTES || memcmp(data.data(), REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0
+        || (data[4] | data[5] << 8) != REPLAY_VERSION) {
+        return false;
+    }
+    rows = data[6];
+    _columns = data[7];
+    if (rows < 1 || _columns < 1 || rows*_columns > REPLAY_SQUARES_MAX) {
+        return false;
+    }
+    _seed = 0;
+    for (int i = 0; i < 8; i ++) {
+        _seed |= (uint64_t)data[8 + i] << (8*i);
+    }
+    offset = REPLAY_HEADER_BYTES;
+    user = Grid(rows, _columns, SHIPS_LIMIT);
+    cpu = Grid(rows, _columns, SHIPS_LIMIT);
+    if (!ReadLayout(data, offset, user) || !ReadLayout(data, offset, cpu)) {
+        return false;
+    }
+    _shots.assign(data.begin() + offset, data.end());
+
+    // Replay the game, checking each shot
+    for (size_t i = 0; i < _shots.size(); i ++) {
+        int square = _shots[i] & ~REPLAY_HIT;
+        Outcome outcome;
+
+        if (0 == i % REPLAY_SNAPSHOT_INTERVAL) {
+            _snapshots.push_back(user);
+            _snapshots.push_back(cpu);
+        }
+        if (!(i % 2 == 0 ? cpu : user).FireShot(square / _columns, square % _columns, outcome)
+            || IsHit(outcome) != ((_shots[i] & REPLAY_HIT) != 0)) {
+            _shots.clear();
+            _snapshots.clear();
+            return false;
+        }
+    }
+    if (0 == _shots.size() % REPLAY_SNAPSHOT_INTERVAL) {
+        _snapshots.push_back(user);
+        _snapshots.push_back(cpu);
+    }
+    return true;
+}
+
+//  Return the random seed the game was started with
+//  Parameters:
+//      none
+//  Returns:
+//      the seed
+//  Possible Errors:
+//      none
+uint64_t ReplayLog::GetSeed() const {
+    return _seed;
+}
+
+//  Return the number of shots in the log
+//  Parameters:
+//      none
+//  Returns:
+//      shot count
+//  Possible Errors:
+//      none
+long ReplayLog::GetShotCount() const {
+    return (long)_shots.size();
+}
+
+//  Retrieve a shot.  Even numbered shots are the user's, fired at the
+//      CPU's grid, and odd numbered shots are the CPU's
+//  Parameters:
+//      i - number of the shot (0 <= i < GetShotCount())
+//      atUser - receives true if the shot was fired at the user's grid
+//      row - receives the row of the shot
+//      column - receives the column of the shot
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void ReplayLog::GetShot(long i, bool& atUser, int& row, int& column) const {
+    int square = _shots[i] & ~REPLAY_HIT;
+
+    atUser = i % 2 == 1;
+    row = square / _columns;
+    column = square % _columns;
+}
+
+//  Rebuild both grids as they were after a number of shots, starting from
+//      the nearest snapshot at or before it
+//  Parameters:
+//      shot - number of shots fired (0 <= shot <= GetShotCount())
+//      user - receives the user's grid
+//      cpu - receives the CPU's grid
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none expected
+void ReplayLog::Seek(long shot, Grid& user, Grid& cpu) const {
+    long snapshot = shot / REPLAY_SNAPSHOT_INTERVAL;
+
+    user = _snapshots[2*snapshot];
+    cpu = _snapshots[2*snapshot + 1];
+    for (long i = snapshot*REPLAY_SNAPSHOT_INTERVAL; i < shot; i ++) {
+        bool atUser;
+        int row;
+        int column;
+        Outcome outcome;
+
+        GetShot(i, atUser, row, column);
+        (atUser ? user : cpu).FireShot(row, column, outcome);
+    }
+}
+
+//  Read a ship layout from the log and place its ships on a grid
+//  Parameters:
+//      data - contents of the log
+//      offset - position of the layout, advanced past it
+//      grid - empty grid to place the ships on
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      layout truncated, ships off the grid or overlapping
+bool ReplayLog::ReadLayout(const vector<unsigned char>& data, size_t& offset, Grid& grid) {
+    int shipCount;
+
+    if (offset >= data.size()) {
+        return false;
+    }
+    shipCount = data[offset++];
+    for (int i = 0; i < shipCount; i ++) {
+        size_t nameLength;
+        string name;
+        int size;
+        int square;
+
+        if (offset >= data.size()) {
+            return false;
+        }
+        nameLength = data[offset++];
+        if (offset + nameLength + 2 > data.size()) {
+            return false;
+        }
+        name.assign((const char*)&data[offset], nameLength);
+        offset += nameLength;
+        size = data[offset] & ~REPLAY_VERTICAL;
+        square = data[offset + 1];
+        if (!grid.AddShip(name, size, (data[offset] & REPLAY_VERTICAL) != 0,
+                          square / _columns, square % _columns)) {
+            return false;
+        }
+        offset += 2;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+// Title: Lab 6 - replayLog.h
+//
+// Purpose: Declares the replay log, a compact append-only record of a game,
+//          and the classes that write it and play it back.
+//
+//          A log starts with a header: the magic, the version, the grid
+//          size and the random seed of the game.  The user's and then the
+//          CPU's ship layout follow, each as a ship count and per ship the
+//          length of its name, the name, its size and orientation, and its
+//          start square.  After that every shot of the game takes one
+//          byte, the user's and the CPU's shots alternating, starting with
+//          the user's.  The square shot is in the low seven bits and
+//          REPLAY_HIT is set if the shot hit a ship.  The rest of the
+//          outcome (sunk, won, shot here before) follows from the layouts,
+//          so playback recomputes it and checks it against the hit bit.
+//
+//          Multi-byte fields are stored little-endian.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_REPLAYLOG_H
+#define BATTLESHIP_REPLAYLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "grid.h"
+
+// Format identification
+const char REPLAY_MAGIC[4] = { 'B', 'S', 'R', 'L' };
+const uint16_t REPLAY_VERSION = 1;
+
+// Bytes before the layouts: magic, version, rows, columns, seed
+const int REPLAY_HEADER_BYTES = 4 + 2 + 1 + 1 + 8;
+
+// Bit of a shot byte set when the shot hit a ship, the rest is the square
+const uint8_t REPLAY_HIT = 0x80;
+
+// Squares a grid may have so that a square fits beside REPLAY_HIT
+const int REPLAY_SQUARES_MAX = REPLAY_HIT;
+
+// Bit of a ship's size byte set for vertical ships
+const uint8_t REPLAY_VERTICAL = 0x80;
+
+// Playback keeps the state of both grids every this many shots
+const int REPLAY_SNAPSHOT_INTERVAL = 16;
+
+//  Streams a game to a replay log.  Each shot is written through to the
+//      file as it is recorded, so the log of an interrupted game is
+//      complete up to its last shot
+class ReplayWriter {
+public:
+    ReplayWriter();
+
+    bool Open(const string& fileName, uint64_t seed, const Grid& user, const Grid& cpu);
+    bool IsOpen() const;
+    bool RecordShot(int row, int column, Outcome outcome);
+    void Close();
+
+private:
+    bool WriteLayout(const Grid& grid);
+
+    ofstream _file;
+    int _columns;
+};
+
+//  A replay log loaded for playback.  The state of both grids after any
+//      shot is rebuilt from the nearest earlier snapshot
+class ReplayLog {
+public:
+    ReplayLog();
+
+    bool Load(const string& fileName);
+
+    uint64_t GetSeed() const;
+    long GetShotCount() const;
+    void GetShot(long i, bool& atUser, int& row, int& column) const;
+    void Seek(long shot, Grid& user, Grid& cpu) const;
+
+private:
+    bool ReadLayout(const vector<unsigned char>& data, size_t& offset, Grid& grid);
+
+    uint64_t _seed;
+    int _columns;
+    vector<unsigned char> _shots;
+    vector<Grid> _snapshots;    // user's and CPU's grid after every REPLAY_SNAPSHOT_INTERVAL shots
+};
+
+#endif //BATTLESHIP_REPLAYLOG_H
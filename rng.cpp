@@ -0,0 +1,166 @@
+// Title: Lab 6 - rng.cpp
+//
+// Purpose: Implements the Rng class, a small fast pseudo random number
+//          generator (xoshiro256**) that can be reproduced from a seed.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <assert.h>
+#include "rng.h"
+
+//  One step of the splitmix64 generator, used to expand seeds
+//  Parameters:
+//      x - generator state, advanced by the call
+//  Returns:
+//      next output
+//  Possible Errors:
+//      none
+static uint64_t SplitMix(uint64_t& x) {
+    uint64_t z;
+
+    z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//  Rotate left
+static inline uint64_t Rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+//
+//  Constructor
+Rng::Rng(uint64_t seed) {
+    Seed(seed);
+}
+
+//
+//  Constructor
+//      Starts at stream number stream of the run with the given seed
+Rng::Rng(uint64_t seed, uint64_t stream) {
+    Seed(seed, stream);
+}
+
+//  Restart the generator from a seed
+//  Parameters:
+//      seed - any value, equal seeds give equal sequences
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Rng::Seed(uint64_t seed) {
+    for (int i = 0; i < 4; i ++) {
+        _state[i] = SplitMix(seed);
+    }
+}
+
+//  Restart the generator at a stream of a run.  Streams are seeded
+//      independently, so stream n is reached without generating streams
+//      0 to n-1
+//  Parameters:
+//      seed - seed of the run
+//      stream - number of the stream, e.g. of a game within the run
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Rng::Seed(uint64_t seed, uint64_t stream) {
+    Seed(MixSeed(seed, stream));
+}
+
+//  Return the next 64 random bits
+//  Parameters:
+//      none
+//  Returns:
+//      random value
+//  Possible Errors:
+//      none
+uint64_t Rng::Next() {
+    uint64_t result;
+    uint64_t t;
+
+    result = Rotl(_state[1] * 5, 7) * 9;
+    t = _state[1] << 17;
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = Rotl(_state[3], 45);
+    return result;
+}
+
+//  Return a random integer in the range [0, n)
+//  Parameters:
+//      n - size of the range, must be positive
+//  Returns:
+//      random value
+//  Possible Errors:
+//      none
+int Rng::Below(int n) {
+    assert(n > 0);
+    return (int)(((Next() >> 32) * (uint64_t)n) >> 32);
+}
+
+//  Advance the generator by 2^128 numbers, as if Next had been called
+//      that many times, using the jump polynomial of xoshiro256**
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Rng::Jump() {
+    static const uint64_t JUMP[4] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    uint64_t state[4] = { 0, 0, 0, 0 };
+
+    for (int i = 0; i < 4; i ++) {
+        for (int b = 0; b < 64; b ++) {
+            if (JUMP[i] & (1ULL << b)) {
+                for (int k = 0; k < 4; k ++) {
+                    state[k] ^= _state[k];
+                }
+            }
+            Next();
+        }
+    }
+    for (int k = 0; k < 4; k ++) {
+        _state[k] = state[k];
+    }
+}
+
+//  Split off a generator for a sub-task.  The returned generator
+//      continues this one's sequence, and this one jumps 2^128 numbers
+//      ahead, so the two never produce overlapping numbers
+//  Parameters:
+//      none
+//  Returns:
+//      the split off generator
+//  Possible Errors:
+//      none
+Rng Rng::Split() {
+    Rng split = *this;
+
+    Jump();
+    return split;
+}
+
+//  Derive the seed of a sub-sequence from a run seed, so that game
+//      number index of a run is the same no matter which thread plays it
+//  Parameters:
+//      seed - seed of the run
+//      index - number of the sub-sequence
+//  Returns:
+//      seed for the sub-sequence
+//  Possible Errors:
+//      none
+uint64_t MixSeed(uint64_t seed, uint64_t index) {
+    uint64_t x;
+
+    x = seed ^ SplitMix(index);
+    return SplitMix(x);
+}
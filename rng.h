@@ -0,0 +1,39 @@
+// Title: Lab 6 - rng.h
+//
+// Purpose: Declares the Rng class, a small fast pseudo random number
+//          generator (xoshiro256**) that can be reproduced from a seed.
+//          There is no global generator: code that needs random numbers is
+//          handed one.  A run is split into numbered streams, one per game,
+//          so any game can be regenerated from the seed and its number
+//          alone, and a stream can be split further with jump-ahead.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_RNG_H
+#define BATTLESHIP_RNG_H
+
+#include <cstdint>
+
+//  Pseudo random number generator
+class Rng {
+public:
+    Rng(uint64_t seed = 1);
+    Rng(uint64_t seed, uint64_t stream);
+
+    void Seed(uint64_t seed);
+    void Seed(uint64_t seed, uint64_t stream);
+    uint64_t Next();
+    int Below(int n);
+
+    void Jump();
+    Rng Split();
+
+private:
+    uint64_t _state[4];
+};
+
+// Derive the seed of a sub-sequence (e.g. one game) from a run seed
+uint64_t MixSeed(uint64_t seed, uint64_t index);
+
+#endif //BATTLESHIP_RNG_H
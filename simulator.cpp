@@ -0,0 +1,292 @@
+// Title: Lab 6 - simulator.cpp
+//
+// Purpose: Implements the Simulator class which plays CPU against CPU games
+//          without any user interface, and the SimulationStats class which
+//          accumulates the results of a batch of games.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <iomanip>
+#include <assert.h>
+#include "simulator.h"
+
+//
+//  Constructor
+SimulationStats::SimulationStats() {
+    Clear();
+}
+
+//  Forget all recorded games
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SimulationStats::Clear() {
+    _games = 0;
+    _totalShots = 0;
+    for (int i = 0; i <= COUNT_SQUARES; i ++) {
+        _histogram[i] = 0;
+    }
+}
+
+//  Record the result of one game
+//  Parameters:
+//      shots - number of shots the winner fired
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SimulationStats::Record(int shots) {
+    assert(shots >= 0 && shots <= COUNT_SQUARES);
+    _games ++;
+    _totalShots += shots;
+    _histogram[shots] ++;
+}
+
+//  Add the results of another batch into this one
+//  Parameters:
+//      other - results to add
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SimulationStats::Merge(const SimulationStats& other) {
+    _games += other._games;
+    _totalShots += other._totalShots;
+    for (int i = 0; i <= COUNT_SQUARES; i ++) {
+        _histogram[i] += other._histogram[i];
+    }
+}
+
+//  Return the number of games recorded
+//  Parameters:
+//      none
+//  Returns:
+//      game count
+//  Possible Errors:
+//      none
+long SimulationStats::GetGames() const {
+    return _games;
+}
+
+//  Return the mean number of shots needed to win
+//  Parameters:
+//      none
+//  Returns:
+//      mean shots, 0 if no games were recorded
+//  Possible Errors:
+//      none
+double SimulationStats::MeanShots() const {
+    return _games == 0 ? 0.0 : (double)_totalShots / _games;
+}
+
+//  Write a summary of the results: games/second, mean shots to win
+//      and the histogram of shots to win
+//  Parameters:
+//      out - stream to write to
+//      seconds - elapsed time the games took
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SimulationStats::Report(ostream& out, double seconds) const {
+    out << "Games:          " << _games << endl;
+    out << "Seconds:        " << fixed << setprecision(3) << seconds << endl;
+    if (seconds > 0) {
+        out << "Games/second:   " << fixed << setprecision(0) << _games / seconds << endl;
+    }
+    out << "Mean shots:     " << fixed << setprecision(2) << MeanShots() << endl;
+    out << "Shots histogram:" << endl;
+    for (int i = 0; i <= COUNT_SQUARES; i ++) {
+        if (_histogram[i] > 0) {
+            out << setw(5) << i << " " << setw(10) << _histogram[i] << endl;
+        }
+    }
+}
+
+//
+//  Constructor
+//  Parameters:
+//      ships - roster of ships each player places
+//      shipCount - number of elements in ships
+//      first - strategy of the player who fires first
+//      second - strategy of the other player
+Simulator::Simulator(const Ship ships[], int shipCount, StrategyKind first, StrategyKind second)
+        : _huntTarget{ CpuLogic(false, ships, shipCount), CpuLogic(false, ships, shipCount) },
+          _endgame{ CpuLogic(true, ships, shipCount), CpuLogic(true, ships, shipCount) },
+          _probability{ ProbabilityLogic(ships, shipCount), ProbabilityLogic(ships, shipCount) } {
+    StrategyKind kinds[2] = { first, second };
+
+    _ships = ships;
+    _shipCount = shipCount;
+    _slot = -1;
+    _game = 0;
+    for (int i = 0; i < 2; i ++) {
+        if (PROBABILITY_DENSITY == kinds[i]) {
+            _players[i] = &_probability[i];
+        }
+        else if (HUNT_TARGET_ENDGAME == kinds[i]) {
+            _players[i] = &_endgame[i];
+        }
+        else {
+            _players[i] = &_huntTarget[i];
+        }
+    }
+}
+
+//  Give the probability density players a model of where opponents place
+//      their ships
+//  Parameters:
+//      heatmap - the model, or nullptr for none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Simulator::UsePriors(const Heatmap* heatmap) {
+    _probability[0].UsePriors(heatmap);
+    _probability[1].UsePriors(heatmap);
+}
+
+//  Publish the games to slots a dashboard shows, each game to the next slot
+//      in turn.  This simulator must be the only writer of the slots, and
+//      they must outlast its games
+//  Parameters:
+//      slots - the slots, none to stop publishing
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Simulator::Watch(const vector<SnapshotSlot*>& slots) {
+    _watched = slots;
+    _watchedGames.assign(slots.size(), 0);
+}
+
+//  Publish the state of the game being played to its slot
+//  Parameters:
+//      shots - shots each player has fired
+//      winner - player who won, or -1 while the game goes on
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Simulator::Publish(const int shots[], int winner) {
+    BoardSnapshot& snapshot = _watched[_slot]->Back();
+
+    snapshot.game = _game;
+    snapshot.games = _watchedGames[_slot];
+    snapshot.winner = winner;
+    for (int player = 0; player < 2; player ++) {
+        const ClassicGrid& target = _grids[1-player];
+
+        snapshot.shots[player] = shots[player];
+        snapshot.occupied[player] = target.GetOccupied();
+        snapshot.shot[player] = target.GetShot();
+        snapshot.sunk[player] = target.GetSunk();
+    }
+    _watched[_slot]->Publish();
+}
+
+//  Play one game.  Both grids get a random placement of the ships, then
+//      the two CPU players alternate shots until one of them wins.  Each
+//      player gets a stream split off the game's generator, so the boards
+//      and one player's shots do not change with the other's strategy
+//  Parameters:
+//      rng - random number generator of the game
+//  Returns:
+//      the number of shots the winner fired
+//  Possible Errors:
+//      none expected
+int Simulator::PlayGame(Rng& rng) {
+    Rng playerRngs[2];
+    int shots[2];
+    int turn;
+
+    playerRngs[0] = rng.Split();
+    playerRngs[1] = rng.Split();
+    _grids[0].RandomlyPlaceShips(_ships, _shipCount, rng);
+    _grids[1].RandomlyPlaceShips(_ships, _shipCount, rng);
+    _players[0]->Init();
+    _players[1]->Init();
+    shots[0] = 0;
+    shots[1] = 0;
+    if (_slot >= 0) {
+        Publish(shots, -1);
+    }
+
+    // Player "turn" fires at the other player's grid
+    turn = 0;
+    for (;;) {
+        int row;
+        int column;
+        Outcome outcome;
+
+        _players[turn]->DetermineShot(row, column, playerRngs[turn]);
+        if (!_grids[1-turn].FireShot(row, column, outcome)) {
+            // The strategies only pick squares on the grid
+            assert(false);
+            outcome = SHOT_HERE_BEFORE;
+        }
+        _players[turn]->ReportOutcome(row, column, outcome);
+        shots[turn] ++;
+        if (_slot >= 0) {
+            Publish(shots, GAME_WON == outcome ? turn : -1);
+        }
+        if (GAME_WON == outcome) {
+            return shots[turn];
+        }
+        turn = 1 - turn;
+    }
+}
+
+//  Play a batch of consecutive games of a run.  Game number n is played
+//      with stream n of the run, so it can be played again on its own.
+//      Watched games are published shot by shot
+//  Parameters:
+//      seed - seed of the run
+//      first - number of the first game of the batch
+//      count - number of games to play
+//      stats - receives the result of each game
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Simulator::PlayGames(uint64_t seed, long first, long count, SimulationStats& stats) {
+    for (long i = first; i < first + count; i ++) {
+        Rng rng(seed, i);
+
+        if (!_watched.empty()) {
+            _slot = (int)(i % (long)_watched.size());
+            _game = i;
+            _watchedGames[_slot] ++;
+        }
+        stats.Record(PlayGame(rng));
+    }
+    _slot = -1;
+}
+
+//  Parse the name of a strategy
+//  Parameters:
+//      name - "hunt", "endgame" or "density"
+//      kind - receives the strategy
+//  Returns:
+//      true if the name is known
+//  Possible Errors:
+//      unknown name
+bool ParseStrategy(const string& name, StrategyKind& kind) {
+    if (name == "hunt") {
+        kind = HUNT_TARGET;
+        return true;
+    }
+    if (name == "endgame") {
+        kind = HUNT_TARGET_ENDGAME;
+        return true;
+    }
+    if (name == "density") {
+        kind = PROBABILITY_DENSITY;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,80 @@
+// Title: Lab 6 - simulator.h
+//
+// Purpose: Declares the Simulator class which plays CPU against CPU games
+//          without any user interface, and the SimulationStats class which
+//          accumulates the results of a batch of games.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_SIMULATOR_H
+#define BATTLESHIP_SIMULATOR_H
+
+#include <ostream>
+#include <vector>
+#include "boardSnapshot.h"
+#include "fixedGrid.h"
+#include "cpulogic.h"
+#include "probabilityLogic.h"
+
+// Shot strategies a simulated player can use
+enum StrategyKind { HUNT_TARGET, HUNT_TARGET_ENDGAME, PROBABILITY_DENSITY };
+
+//  Class accumulating the results of a batch of games
+//      games - number of games played
+//      totalShots - sum over the games of the shots the winner fired
+//      histogram - histogram[n] is the number of games won in n shots
+class SimulationStats {
+public:
+    SimulationStats();
+
+    void Clear();
+    void Record(int shots);
+    void Merge(const SimulationStats& other);
+    void Report(ostream& out, double seconds) const;
+
+    long GetGames() const;
+    double MeanShots() const;
+
+private:
+    long _games;
+    long _totalShots;
+    long _histogram[COUNT_SQUARES+1];
+};
+
+//  Class that plays CPU against CPU games on a pair of classic grids using
+//      the CpuLogic DetermineShot/ReportOutcome contract and no display
+class Simulator {
+public:
+    Simulator(const Ship ships[], int shipCount,
+              StrategyKind first = HUNT_TARGET, StrategyKind second = HUNT_TARGET);
+
+    void UsePriors(const Heatmap* heatmap);
+    void Watch(const vector<SnapshotSlot*>& slots);
+    int PlayGame(Rng& rng);
+    void PlayGames(uint64_t seed, long first, long count, SimulationStats& stats);
+
+private:
+    void Publish(const int shots[], int winner);
+
+    const Ship* _ships;
+    int _shipCount;
+    ClassicGrid _grids[2];
+
+    // One of each strategy per player, _players points at the ones in use
+    CpuLogic _huntTarget[2];
+    CpuLogic _endgame[2];
+    ProbabilityLogic _probability[2];
+    ShotStrategy* _players[2];
+
+    // Slots the games are published to in turn, the games played in each,
+    // and the slot and number of the game being played, if it is watched
+    vector<SnapshotSlot*> _watched;
+    vector<uint64_t> _watchedGames;
+    int _slot;
+    long _game;
+};
+
+bool ParseStrategy(const string& name, StrategyKind& kind);
+
+#endif //BATTLESHIP_SIMULATOR_H
@@ -0,0 +1,75 @@
+// Title: Lab 6 - simulatorMain.cpp
+//
+// Purpose: Drive the headless simulator, playing a tournament of CPU against
+//          CPU games across all cores and reporting games/second, mean shots
+//          to win and the histogram of shots to win
+//
+//          Usage: Simulator [-heatmap model] [games [seed [threads [strategy [strategy]]]]]
+//              where a strategy is "hunt" (hunt/target), "endgame"
+//              (hunt/target with the endgame solver) or "density"
+//              (probability density)
+//
+//          A model built by TrainHeatmap gives the density players priors
+//          on where the ships are.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <string>
+#include "tournament.h"
+
+const long DEFAULT_GAMES = 100000;
+const uint64_t DEFAULT_SEED = 1;
+
+int main(int argc, char* argv[]) {
+    long games;
+    uint64_t seed;
+    int threads;
+    StrategyKind strategies[2] = { HUNT_TARGET, HUNT_TARGET };
+    SimulationStats stats;
+    Heatmap heatmap;
+    bool useHeatmap;
+    char** args;
+    int count;
+
+    // The model comes first, then the rest as without it
+    useHeatmap = argc > 2 && string(argv[1]) == "-heatmap";
+    if (useHeatmap && !heatmap.Load(argv[2])) {
+        cerr << "Cannot read heatmap " << argv[2] << endl;
+        return 1;
+    }
+    args = useHeatmap ? argv + 2 : argv;
+    count = useHeatmap ? argc - 2 : argc;
+    games = count > 1 ? atol(args[1]) : DEFAULT_GAMES;
+    seed = count > 2 ? strtoull(args[2], nullptr, 10) : DEFAULT_SEED;
+    threads = count > 3 ? atoi(args[3]) : (int)thread::hardware_concurrency();
+    if (count > 4 && !ParseStrategy(args[4], strategies[0])) {
+        games = 0;
+    }
+    strategies[1] = strategies[0];
+    if (count > 5 && !ParseStrategy(args[5], strategies[1])) {
+        games = 0;
+    }
+    if (games <= 0) {
+        cerr << "Usage: " << argv[0] << " [-heatmap model] [games [seed [threads [hunt|endgame|density [hunt|endgame|density]]]]]" << endl;
+        return 1;
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+
+    Tournament tournament(CLASSIC_SHIPS, CLASSIC_SHIP_COUNT, threads, strategies[0], strategies[1]);
+    tournament.UsePriors(useHeatmap ? &heatmap : nullptr);
+
+    auto start = chrono::steady_clock::now();
+    tournament.Run(games, seed, stats);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Threads:        " << threads << endl;
+    stats.Report(cout, elapsed.count());
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Title: Lab 6 - speculativeStrategy.cpp
+//
+// Purpose: Implements the SpeculativeStrategy class declared in
+//          speculativeStrategy.h.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <assert.h>
+#include "speculativeStrategy.h"
+
+//
+//  Constructor
+//  Parameters:
+//      strategy - the strategy deciding the shots, used only through this
+//      rng - the random number stream the strategy picks shots with
+SpeculativeStrategy::SpeculativeStrategy(ShotStrategy& strategy, Rng& rng)
+        : _strategy(strategy), _rng(rng) {
+    _ready = false;
+    _row = 0;
+    _column = 0;
+}
+
+//
+//  Destructor
+//      Waits for the thread still thinking about a shot that will not be fired
+SpeculativeStrategy::~SpeculativeStrategy() {
+    Wait();
+}
+
+//  Forget everything learned, ready for a new game, and start thinking
+//      about the first shot
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SpeculativeStrategy::Init() {
+    Wait();
+    _strategy.Init();
+    StartThinking();
+}
+
+//  Hand over the next shot, waiting for the thread to finish deciding it
+//      if it has not yet
+//  Parameters:
+//      row - receives the row of the shot
+//      column - receives the column of the shot
+//      rng - the stream given to the constructor, which the thread drew from
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      must not be called once every square has been fired at
+void SpeculativeStrategy::DetermineShot(int& row, int& column, Rng& rng) {
+    assert(&rng == &_rng);
+    Wait();
+    if (!_ready) {
+        _strategy.DetermineShot(_row, _column, rng);
+    }
+    row = _row;
+    column = _column;
+    _ready = false;
+}
+
+//  Learn the outcome of the last shot and start thinking about the next,
+//      unless the game is over
+//  Parameters:
+//      row - row of the shot
+//      column - column of the shot
+//      outcome - what the shot did
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SpeculativeStrategy::ReportOutcome(int row, int column, Outcome outcome) {
+    Wait();
+    _strategy.ReportOutcome(row, column, outcome);
+    if (GAME_WON != outcome) {
+        StartThinking();
+    }
+}
+
+//  Start the thread deciding the next shot
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SpeculativeStrategy::StartThinking() {
+    _ready = false;
+    _thinker = thread(&SpeculativeStrategy::Think, this);
+}
+
+//  Body of the thread: decide the next shot
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SpeculativeStrategy::Think() {
+    _strategy.DetermineShot(_row, _column, _rng);
+    _ready = true;
+}
+
+//  Wait for the thread, if one is thinking.  Joining it makes what it
+//      wrote visible to this thread
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void SpeculativeStrategy::Wait() {
+    if (_thinker.joinable()) {
+        _thinker.join();
+    }
+}
@@ -0,0 +1,48 @@
+// Title: Lab 6 - speculativeStrategy.h
+//
+// Purpose: Declares the SpeculativeStrategy class, a ShotStrategy that
+//          works out the next shot of another strategy on a thread of its
+//          own as soon as the outcome of the last shot is reported, so that
+//          when the CPU's turn comes the shot is already known.  The user's
+//          turn hides the time an expensive strategy, e.g. the probability
+//          density or the endgame solver, takes to decide.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_SPECULATIVESTRATEGY_H
+#define BATTLESHIP_SPECULATIVESTRATEGY_H
+
+#include <thread>
+#include "cpulogic.h"
+
+//  Strategy that thinks ahead on a background thread
+//      While the thread thinks the strategy it wraps and the random number
+//      stream belong to the thread; every other call waits for it first.
+//      The shots are the same as those of the strategy it wraps, only
+//      decided earlier.
+class SpeculativeStrategy : public ShotStrategy {
+public:
+    SpeculativeStrategy(ShotStrategy& strategy, Rng& rng);
+    ~SpeculativeStrategy();
+
+    void Init() override;
+    void DetermineShot(int& row, int& column, Rng& rng) override;
+    void ReportOutcome(int row, int column, Outcome outcome) override;
+
+private:
+    void StartThinking();
+    void Think();
+    void Wait();
+
+    ShotStrategy& _strategy;
+    Rng& _rng;
+    thread _thinker;
+
+    // The next shot, valid once the thinker is done
+    bool _ready;
+    int _row;
+    int _column;
+};
+
+#endif //BATTLESHIP_SPECULATIVESTRATEGY_H
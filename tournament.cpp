@@ -0,0 +1,250 @@
+// Title: Lab 6 - tournament.cpp
+//
+// Purpose: Implements the Tournament class which spreads a large number of
+//          headless CPU against CPU games across several threads.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <thread>
+#include <assert.h>
+#include "tournament.h"
+#include "rng.h"
+
+//  Pack a range of batch numbers into one word
+static inline uint64_t PackRange(uint32_t begin, uint32_t end) {
+    return ((uint64_t)begin << 32) | end;
+}
+
+//
+//  Constructor
+BatchDeque::BatchDeque() {
+    _range.store(0);
+}
+
+//  Give the deque a new range of batches.  Only the owner calls this and
+//      only when its deque is empty, so thieves never see a partial update
+//  Parameters:
+//      begin - first batch number
+//      end - one past the last batch number
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void BatchDeque::Reset(uint32_t begin, uint32_t end) {
+    _range.store(PackRange(begin, end));
+}
+
+//  Owner takes the batch at the front of the deque
+//  Parameters:
+//      batch - receives the batch number
+//  Returns:
+//      true if a batch was taken, false if the deque is empty
+//  Possible Errors:
+//      none
+bool BatchDeque::Take(uint32_t& batch) {
+    uint64_t range;
+
+    range = _range.load();
+    for (;;) {
+        uint32_t begin = (uint32_t)(range >> 32);
+        uint32_t end = (uint32_t)range;
+
+        if (begin >= end) {
+            return false;
+        }
+        if (_range.compare_exchange_weak(range, PackRange(begin + 1, end))) {
+            batch = begin;
+            return true;
+        }
+    }
+}
+
+//  Thief takes the back half of the deque
+//  Parameters:
+//      begin - receives the first stolen batch number
+//      end - receives one past the last stolen batch number
+//  Returns:
+//      true if batches were stolen, false if the deque is empty
+//  Possible Errors:
+//      none
+bool BatchDeque::Steal(uint32_t& begin, uint32_t& end) {
+    uint64_t range;
+
+    range = _range.load();
+    for (;;) {
+        uint32_t front = (uint32_t)(range >> 32);
+        uint32_t back = (uint32_t)range;
+        uint32_t middle;
+
+        if (front >= back) {
+            return false;
+        }
+        middle = front + (back - front) / 2;
+        if (_range.compare_exchange_weak(range, PackRange(front, middle))) {
+            begin = middle;
+            end = back;
+            return true;
+        }
+    }
+}
+
+//
+//  Constructor
+Tournament::Tournament(const Ship ships[], int shipCount, int threadCount,
+                       StrategyKind first, StrategyKind second)
+        : _deques(threadCount > 0 ? threadCount : 1) {
+    _ships = ships;
+    _shipCount = shipCount;
+    _threadCount = threadCount > 0 ? threadCount : 1;
+    _strategies[0] = first;
+    _strategies[1] = second;
+    _heatmap = nullptr;
+    _slots = nullptr;
+    _slotCount = 0;
+    _stopped.store(false);
+    _gamesPlayed.store(0);
+}
+
+//  Give the probability density players a model of where opponents place
+//      their ships.  The model must outlast the runs
+//  Parameters:
+//      heatmap - the model, or nullptr for none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Tournament::UsePriors(const Heatmap* heatmap) {
+    _heatmap = heatmap;
+}
+
+//  Publish games to slots a dashboard shows.  Slot i is written only by
+//      worker i % threads, so slots beyond the first threads are shared
+//      out among the workers and each has a single writer
+//  Parameters:
+//      slots - the slots, which must outlast the runs
+//      count - number of slots
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Tournament::Watch(SnapshotSlot slots[], int count) {
+    _slots = slots;
+    _slotCount = count;
+}
+
+//  Ask a run to end early, from another thread.  The workers stop once
+//      their current batch is played
+//  Parameters:
+//      none
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Tournament::Stop() {
+    _stopped.store(true);
+}
+
+//  Return the number of games played so far in the current or last run,
+//      from any thread.  Counted a batch at a time
+//  Parameters:
+//      none
+//  Returns:
+//      games played
+//  Possible Errors:
+//      none
+long Tournament::GetGamesPlayed() const {
+    return _gamesPlayed.load(memory_order_relaxed);
+}
+
+//  Play a number of games across all threads.  Game number n is always
+//      played with stream n of the seed, so the results depend only on
+//      the seed and not on the number of threads.  Stop ends a run early,
+//      with the games played until then in the results
+//  Parameters:
+//      games - number of games to play
+//      seed - seed of the run
+//      stats - receives the merged results
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Tournament::Run(long games, uint64_t seed, SimulationStats& stats) {
+    vector<SimulationStats> workerStats(_threadCount);
+    vector<thread> threads;
+    uint32_t batches;
+
+    batches = (uint32_t)((games + GAMES_PER_BATCH - 1) / GAMES_PER_BATCH);
+    _gamesPlayed.store(0);
+
+    // Deal the batches out evenly, stealing evens out the rest
+    for (int i = 0; i < _threadCount; i ++) {
+        _deques[i].Reset((uint32_t)((uint64_t)batches * i / _threadCount),
+                         (uint32_t)((uint64_t)batches * (i + 1) / _threadCount));
+    }
+
+    for (int i = 1; i < _threadCount; i ++) {
+        threads.push_back(thread(&Tournament::Work, this, i, games, seed, ref(workerStats[i])));
+    }
+    Work(0, games, seed, workerStats[0]);
+    for (size_t i = 0; i < threads.size(); i ++) {
+        threads[i].join();
+    }
+
+    for (int i = 0; i < _threadCount; i ++) {
+        stats.Merge(workerStats[i]);
+    }
+}
+
+//  Body of a worker thread: play batches from its own deque, then steal
+//      from the others until no batches remain
+//  Parameters:
+//      worker - index of the worker
+//      games - total number of games in the run
+//      seed - seed of the run
+//      stats - the worker's own statistics
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Tournament::Work(int worker, long games, uint64_t seed, SimulationStats& stats) {
+    Simulator simulator(_ships, _shipCount, _strategies[0], _strategies[1]);
+    vector<SnapshotSlot*> slots;
+    uint32_t batch;
+
+    simulator.UsePriors(_heatmap);
+    for (int i = worker; i < _slotCount; i += _threadCount) {
+        slots.push_back(&_slots[i]);
+    }
+    simulator.Watch(slots);
+    do {
+        while (!_stopped.load(memory_order_relaxed) && _deques[worker].Take(batch)) {
+            long first = (long)batch * GAMES_PER_BATCH;
+            long count = games - first < GAMES_PER_BATCH ? games - first : GAMES_PER_BATCH;
+
+            simulator.PlayGames(seed, first, count, stats);
+            _gamesPlayed.fetch_add(count, memory_order_relaxed);
+        }
+    } while (!_stopped.load(memory_order_relaxed) && StealBatches(worker));
+}
+
+//  Move the back half of another worker's deque into this worker's
+//      (empty) deque
+//  Parameters:
+//      worker - index of the thief
+//  Returns:
+//      true if batches were stolen, false if every deque is empty
+//  Possible Errors:
+//      none
+bool Tournament::StealBatches(int worker) {
+    for (int i = 1; i < _threadCount; i ++) {
+        uint32_t begin;
+        uint32_t end;
+
+        if (_deques[(worker + i) % _threadCount].Steal(begin, end)) {
+            _deques[worker].Reset(begin, end);
+            return true;
+        }
+    }
+    return false;
+}
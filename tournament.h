@@ -0,0 +1,68 @@
+// Title: Lab 6 - tournament.h
+//
+// Purpose: Declares the Tournament class which spreads a large number of
+//          headless CPU against CPU games across several threads.  Games
+//          are handed out in batches through work-stealing deques, and
+//          each thread keeps its own Simulator and statistics so that the
+//          game loop takes no locks.  Every game has its own random number
+//          stream, so a game plays the same on whichever thread runs it.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#ifndef BATTLESHIP_TOURNAMENT_H
+#define BATTLESHIP_TOURNAMENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "simulator.h"
+
+// Number of games handed out at a time
+const int GAMES_PER_BATCH = 256;
+
+//  Deque of batch numbers still to be played by one worker.  The range
+//      [begin, end) is packed into a single atomic word: the owner takes
+//      batches from the front and thieves take the back half, each with
+//      a single compare and swap.
+class BatchDeque {
+public:
+    BatchDeque();
+
+    void Reset(uint32_t begin, uint32_t end);
+    bool Take(uint32_t& batch);
+    bool Steal(uint32_t& begin, uint32_t& end);
+
+private:
+    atomic<uint64_t> _range;
+};
+
+//  Class that plays games on several threads and merges the results
+class Tournament {
+public:
+    Tournament(const Ship ships[], int shipCount, int threadCount,
+               StrategyKind first = HUNT_TARGET, StrategyKind second = HUNT_TARGET);
+
+    void UsePriors(const Heatmap* heatmap);
+    void Watch(SnapshotSlot slots[], int count);
+    void Run(long games, uint64_t seed, SimulationStats& stats);
+    void Stop();
+    long GetGamesPlayed() const;
+
+private:
+    void Work(int worker, long games, uint64_t seed, SimulationStats& stats);
+    bool StealBatches(int worker);
+
+    const Ship* _ships;
+    int _shipCount;
+    int _threadCount;
+    StrategyKind _strategies[2];
+    const Heatmap* _heatmap;
+    SnapshotSlot* _slots;
+    int _slotCount;
+    vector<BatchDeque> _deques;
+    atomic<bool> _stopped;
+    atomic<long> _gamesPlayed;
+};
+
+#endif //BATTLESHIP_TOURNAMENT_H
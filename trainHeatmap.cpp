@@ -0,0 +1,293 @@
+// Title: Lab 6 - trainHeatmap.cpp
+//
+// Purpose: Train a Heatmap, the model of where opponents place their
+//          ships, from a corpus of saved layouts, see heatmap.h
+//
+//          Usage: TrainHeatmap [-threads count] corpus... output.model
+//
+//          A corpus is either a binary board file (see boardFile.h) or
+//          layouts back to back in the text format read by
+//          Grid::LoadShips.  Both are memory-mapped and cut into chunks
+//          that all the threads work through, each counting into its own
+//          model, and the models are merged at the end.  Text is cut at
+//          the start of a layout, a line holding a lone ship count.  Bad
+//          layouts are skipped, ValidateLayouts reports where they are.
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "boardFile.h"
+#include "heatmap.h"
+#include "layoutValidator.h"
+
+// Size of the chunks the corpora are cut into
+const size_t TEXT_CHUNK_BYTES = 16 << 20;
+const long BOARD_CHUNK_RECORDS = 1 << 18;
+
+// A corpus file: a board file, or else mapped text
+//      name - name of the file
+//      boards - the board file, open if the corpus is one
+//      text, size - the mapped text otherwise
+struct Corpus {
+    string name;
+    BoardCorpus boards;
+    const char* text;
+    size_t size;
+};
+
+// A chunk of a corpus: bytes of text or records of a board file
+struct Chunk {
+    int corpus;
+    size_t begin;
+    size_t end;
+};
+
+//  Counts each good layout the validator reads into a model
+class HeatmapSink : public LayoutSink {
+public:
+    HeatmapSink(Heatmap& heatmap) : _heatmap(heatmap) {}
+
+    void Layout(const Ship ships[], int shipCount) override {
+        _heatmap.Add(ships, shipCount);
+    }
+
+private:
+    Heatmap& _heatmap;
+};
+
+//  Map a corpus file, as a board file if it is one and as text otherwise
+//  Parameters:
+//      corpus - receives the mapping, name must be set
+//  Returns:
+//      success/failure
+//  Possible Errors:
+//      file cannot be opened or mapped
+bool OpenCorpus(Corpus& corpus) {
+    int fd;
+    struct stat info;
+    void* data;
+
+    corpus.text = nullptr;
+    corpus.size = 0;
+    if (corpus.boards.Open(corpus.name)) {
+        return true;
+    }
+    fd = open(corpus.name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    if (0 == info.st_size) {
+        close(fd);
+        return true;
+    }
+    data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data) {
+        return false;
+    }
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    corpus.text = (const char*)data;
+    corpus.size = info.st_size;
+    return true;
+}
+
+//  Find where the first layout at or after a point of a text starts: the
+//      first line from the next line on that holds a lone count
+//  Parameters:
+//      text - the text
+//      size - number of bytes in text
+//      offset - the point, 0 for the start of the text
+//  Returns:
+//      offset of the start of the layout, or size if there is none
+//  Possible Errors:
+//      none
+size_t FindLayoutStart(const char* text, size_t size, size_t offset) {
+    if (0 == offset) {
+        return 0;
+    }
+    while (offset < size) {
+        const char* newline = (const char*)memchr(text + offset - 1, '\n', size - offset + 1);
+        size_t i;
+        int digits;
+
+        if (!newline) {
+            return size;
+        }
+        offset = newline - text + 1;
+        i = offset;
+        while (i < size && (' ' == text[i] || '\t' == text[i] || '\r' == text[i])) {
+            i ++;
+        }
+        for (digits = 0; i < size && text[i] >= '0' && text[i] <= '9'; digits ++) {
+            i ++;
+        }
+        while (i < size && (' ' == text[i] || '\t' == text[i] || '\r' == text[i])) {
+            i ++;
+        }
+        if (digits > 0 && (i == size || '\n' == text[i])) {
+            return offset;
+        }
+        offset ++;
+    }
+    return size;
+}
+
+//  Body of a training thread: take chunks until there are none left,
+//      counting their layouts into the thread's own model
+//  Parameters:
+//      corpora - the corpora
+//      chunks - the chunks of all the corpora
+//      next - number of the next chunk to take, shared by the threads
+//      heatmap - the thread's model
+//      bad - receives the number of bad layouts
+//  Returns:
+//      nothing
+//  Possible Errors:
+//      none
+void Train(const vector<Corpus>& corpora, const vector<Chunk>& chunks, atomic<size_t>& next,
+           Heatmap& heatmap, long& bad) {
+    ostream noReport(nullptr);
+    HeatmapSink sink(heatmap);
+    vector<Ship> ships;
+    size_t i;
+
+    bad = 0;
+    while ((i = next.fetch_add(1)) < chunks.size()) {
+        const Chunk& chunk = chunks[i];
+        const Corpus& corpus = corpora[chunk.corpus];
+
+        if (corpus.text) {
+            LayoutValidator validator(noReport, &sink);
+
+            validator.Feed(corpus.text + chunk.begin, chunk.end - chunk.begin);
+            validator.Finish();
+            bad += validator.GetBadLayouts();
+            continue;
+        }
+        ships.resize(corpus.boards.GetShipsMax());
+        for (size_t j = chunk.begin; j < chunk.end; j ++) {
+            BoardView board = corpus.boards.GetBoard((long)j);
+            int count = board.GetShipCount();
+
+            for (int k = 0; k < count && k < (int)ships.size(); k ++) {
+                board.GetShip(k, ships[k]);
+            }
+            if (count > (int)ships.size() || !heatmap.Add(ships.data(), count)) {
+                bad ++;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int threadCount;
+    int first;
+    vector<Chunk> chunks;
+    atomic<size_t> next;
+    vector<thread> threads;
+    vector<long> bad;
+    long badTotal;
+    chrono::steady_clock::time_point start;
+    double seconds;
+
+    threadCount = (int)thread::hardware_concurrency();
+    first = 1;
+    if (argc > 2 && string(argv[1]) == "-threads") {
+        threadCount = atoi(argv[2]);
+        first = 3;
+    }
+    if (argc < first + 2 || threadCount < 0) {
+        cerr << "Usage: " << argv[0] << " [-threads count] corpus... output.model" << endl;
+        return 1;
+    }
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    start = chrono::steady_clock::now();
+
+    // Map the corpora and cut them into chunks
+    vector<Corpus> corpora(argc - first - 1);
+    for (int i = 0; i < (int)corpora.size(); i ++) {
+        Corpus& corpus = corpora[i];
+
+        corpus.name = argv[first + i];
+        if (!OpenCorpus(corpus)) {
+            cerr << "Cannot read " << corpus.name << endl;
+            return 1;
+        }
+        if (corpus.text) {
+            size_t begin = 0;
+
+            while (begin < corpus.size) {
+                size_t end = FindLayoutStart(corpus.text, corpus.size,
+                                             begin + TEXT_CHUNK_BYTES < corpus.size ? begin + TEXT_CHUNK_BYTES : corpus.size);
+
+                chunks.push_back(Chunk { i, begin, end });
+                begin = end;
+            }
+        }
+        else if (corpus.boards.GetCount() > 0 && (corpus.boards.GetRows() != COUNT_ROWS
+                                                  || corpus.boards.GetColumns() != COUNT_COLUMNS)) {
+            cerr << corpus.name << " is not of " << COUNT_ROWS << "x" << COUNT_COLUMNS << " boards" << endl;
+            return 1;
+        }
+        else {
+            for (long begin = 0; begin < corpus.boards.GetCount(); begin += BOARD_CHUNK_RECORDS) {
+                long end = begin + BOARD_CHUNK_RECORDS < corpus.boards.GetCount()
+                           ? begin + BOARD_CHUNK_RECORDS : corpus.boards.GetCount();
+
+                chunks.push_back(Chunk { i, (size_t)begin, (size_t)end });
+            }
+        }
+    }
+
+    // Count on every thread, then merge
+    vector<Heatmap> heatmaps(threadCount);
+    bad.assign(threadCount, 0);
+    next.store(0);
+    for (int i = 1; i < threadCount; i ++) {
+        threads.push_back(thread(Train, cref(corpora), cref(chunks), ref(next), ref(heatmaps[i]), ref(bad[i])));
+    }
+    Train(corpora, chunks, next, heatmaps[0], bad[0]);
+    for (int i = 0; i < (int)threads.size(); i ++) {
+        threads[i].join();
+    }
+    badTotal = bad[0];
+    for (int i = 1; i < threadCount; i ++) {
+        heatmaps[0].Merge(heatmaps[i]);
+        badTotal += bad[i];
+    }
+    for (int i = 0; i < (int)corpora.size(); i ++) {
+        if (corpora[i].text) {
+            munmap((void*)corpora[i].text, corpora[i].size);
+        }
+    }
+
+    if (!heatmaps[0].Save(argv[argc-1])) {
+        cerr << "Cannot write " << argv[argc-1] << endl;
+        return 1;
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << heatmaps[0].GetLayouts() << " layouts, " << badTotal << " bad, "
+         << threadCount << " threads, " << seconds << " seconds";
+    if (seconds > 0) {
+        cout << ", " << heatmaps[0].GetLayouts()/seconds << " layouts/s";
+    }
+    cout << endl;
+    return 0;
+}
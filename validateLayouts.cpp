@@ -0,0 +1,91 @@
+// Title: Lab 6 - validateLayouts.cpp
+//
+// Purpose: Check streams of ship layouts in the text format read by
+//          Grid::LoadShips, reporting every bad layout with its byte
+//          offset.  Files are read in large chunks so corpora of any
+//          size are checked without being held in memory.
+//
+//          Usage: ValidateLayouts file...   ("-" reads standard input)
+//
+// Class: CSC 2430 Winter 2020
+// Author: Max Benson
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "layoutValidator.h"
+
+// Size of each read
+const size_t CHUNK_SIZE = 1 << 20;
+
+//  Check one file
+//  Parameters:
+//      name - name of the file, "-" for standard input
+//      buffer - chunk buffer of CHUNK_SIZE bytes
+//      validator - validator the file is fed to
+//  Returns:
+//      true if the whole file was read
+//  Possible Errors:
+//      file cannot be opened or read
+bool ValidateFile(const char* name, char* buffer, LayoutValidator& validator) {
+    bool isStdin = string("-") == name;
+    int fd;
+    ssize_t length;
+
+    fd = isStdin ? STDIN_FILENO : open(name, O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot open " << name << endl;
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    while ((length = read(fd, buffer, CHUNK_SIZE)) > 0) {
+        validator.Feed(buffer, (size_t)length);
+    }
+    if (!isStdin) {
+        close(fd);
+    }
+    if (length < 0) {
+        cerr << "Cannot read " << name << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    vector<char> buffer(CHUNK_SIZE);
+    bool ok;
+    double seconds;
+
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " file...   (\"-\" reads standard input)" << endl;
+        return 2;
+    }
+    ok = true;
+    for (int i = 1; i < argc; i ++) {
+        LayoutValidator validator(cout);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        cout << argv[i] << ":" << endl;
+        if (!ValidateFile(argv[i], buffer.data(), validator)) {
+            ok = false;
+            continue;
+        }
+        validator.Finish();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << validator.GetLayouts() << " layouts, "
+             << validator.GetBadLayouts() << " bad, "
+             << validator.GetBytes() << " bytes";
+        if (seconds > 0) {
+            cout << ", " << validator.GetBytes()/seconds/1e6 << " MB/s";
+        }
+        cout << endl;
+        if (validator.GetBadLayouts() > 0) {
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}